@@ -0,0 +1,109 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#include "BenchCase.h"
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+using ees2d::bench::BenchCase;
+
+
+BenchCase &ees2d::bench::benchCase(const std::string &meshName) {
+	static std::map<std::string, std::unique_ptr<BenchCase>> cases;
+
+	auto found = cases.find(meshName);
+	if (found != cases.end()) {
+		return *found->second;
+	}
+
+	// Preprocessing logs would break the benchmark table
+	std::ostringstream log;
+	std::streambuf *coutBuffer = std::cout.rdbuf(log.rdbuf());
+
+	auto bench = std::make_unique<BenchCase>();
+	std::string controlFile = std::string(EES2D_SOURCE_DIR) + "/tests/ControlFile.ees2d";// Freestream and scheme settings
+	bench->parameters = std::make_unique<ees2d::io::InputParser>(controlFile);
+	bench->parameters->parse();
+	bench->parameters->m_meshFile = std::string(EES2D_SOURCE_DIR) + "/tests/" + meshName;
+	bench->parameters->m_threads = 1;
+
+	bench->parser = std::make_unique<ees2d::io::Su2Parser>(bench->parameters->m_meshFile);
+	bench->parser->Parse();
+	bench->connectivity = std::make_unique<ees2d::mesh::Connectivity>(*bench->parser);
+	bench->connectivity->solve();
+	bench->metrics = std::make_unique<ees2d::mesh::MetricsData>();
+	bench->metrics->compute(*bench->connectivity);
+	bench->mesh = std::make_unique<ees2d::mesh::Mesh>(*bench->connectivity, *bench->metrics);
+	bench->sim = std::make_unique<ees2d::solver::Simulation>(*bench->mesh, *bench->parameters);
+	bench->solver = std::make_unique<ees2d::solver::Solver>(*bench->sim, *bench->mesh);
+
+	std::cout.rdbuf(coutBuffer);
+
+	ees2d::mesh::Mesh &mesh = *bench->mesh;
+	for (uint32_t iface = 0; iface < mesh.N_faces; iface++) {
+		const uint32_t elem2 = mesh.FaceToElem(iface, 1);
+		if (elem2 < mesh.N_elems) {
+			bench->interiorFaces.push_back(iface);
+		} else if (elem2 == uint32_t(-1)) {
+			bench->wallFaces.push_back(iface);
+		} else if (elem2 == uint32_t(-3)) {
+			bench->farfieldFaces.push_back(iface);
+		}
+	}
+
+	setSyntheticState(*bench);
+	return *cases.emplace(meshName, std::move(bench)).first->second;
+}
+
+//---------------------------------------------------------------
+void ees2d::bench::setSyntheticState(BenchCase &bench) {
+	ees2d::solver::Simulation &sim = *bench.sim;
+	const double gamma = sim.gammaInf;
+
+	for (uint32_t ielem = 0; ielem < bench.mesh->N_elems; ielem++) {
+		const double perturbation = 0.05 * std::sin(0.37 * ielem);
+
+		sim.rho[ielem] = sim.rhoInf * (1 + perturbation);
+		sim.u[ielem] = sim.uInf * (1 - perturbation);
+		sim.v[ielem] = sim.vInf + 0.02 * std::cos(0.11 * ielem);
+		sim.p[ielem] = sim.pressureInf * (1 + 2 * perturbation);
+
+		const double kinetic = (sim.u[ielem] * sim.u[ielem] + sim.v[ielem] * sim.v[ielem]) / 2;
+		sim.E[ielem] = sim.p[ielem] / ((gamma - 1) * sim.rho[ielem]) + kinetic;
+		sim.H[ielem] = sim.E[ielem] + sim.p[ielem] / sim.rho[ielem];
+		sim.Mach[ielem] = std::sqrt(2 * kinetic) / std::sqrt(gamma * sim.p[ielem] / sim.rho[ielem]);
+
+		sim.conservativeVariables[ielem] = ees2d::solver::ConservativeVariables(sim.rho[ielem], sim.rho[ielem] * sim.u[ielem],
+		                                                                          sim.rho[ielem] * sim.v[ielem], sim.rho[ielem] * sim.E[ielem]);
+		sim.residuals[ielem] = ees2d::solver::Residual(1e-3 * perturbation, 2e-3 * perturbation, -1e-3 * perturbation, 5e-3 * perturbation);
+		sim.dt[ielem] = 1e-3;
+	}
+}
+
+//---------------------------------------------------------------
+void ees2d::bench::setRates(benchmark::State &state, size_t items, size_t bytesPerItem, const std::string &counterName) {
+	state.counters[counterName] = benchmark::Counter(double(state.iterations()) * items, benchmark::Counter::kIsRate);
+	state.SetBytesProcessed(int64_t(state.iterations()) * items * bytesPerItem);
+}
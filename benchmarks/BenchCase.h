@@ -0,0 +1,72 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#pragma once
+
+#include "io/InputParser.h"
+#include "io/Su2Parser.h"
+#include "mesh/Connectivity.h"
+#include "mesh/Mesh.h"
+#include "mesh/Metrics.h"
+#include "solver/Simulation.h"
+#include "solver/Solver.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ees2d::bench {
+
+	struct BenchCase {
+		// A test mesh from tests/ with the whole preprocessing chain and a solver around it. The state is
+		// synthetic : freestream with smooth perturbations, so the kernels don't all take the uniform path
+		std::unique_ptr<ees2d::io::InputParser> parameters;
+		std::unique_ptr<ees2d::io::Su2Parser> parser;
+		std::unique_ptr<ees2d::mesh::Connectivity> connectivity;
+		std::unique_ptr<ees2d::mesh::MetricsData> metrics;
+		std::unique_ptr<ees2d::mesh::Mesh> mesh;
+		std::unique_ptr<ees2d::solver::Simulation> sim;
+		std::unique_ptr<ees2d::solver::Solver> solver;
+
+		std::vector<uint32_t> interiorFaces;
+		std::vector<uint32_t> wallFaces;
+		std::vector<uint32_t> farfieldFaces;
+	};
+
+	// Built on first use and kept for the following benchmarks, meshName is a file of tests/
+	BenchCase &benchCase(const std::string &meshName);
+
+	// Reset the conservative, primitive and residual arrays to the synthetic state
+	void setSyntheticState(BenchCase &bench);
+
+	// Items (faces or elements) per second under counterName, and bytes per second from the
+	// bytes one item has to move at least once (inputs read and outputs written)
+	void setRates(benchmark::State &state, size_t items, size_t bytesPerItem, const std::string &counterName);
+
+}// namespace ees2d::bench
+
+// Registers a benchmark function taking the mesh file name on the small and the NACA test meshes
+#define EES2D_BENCHMARK_MESHES(function)                                   \
+	BENCHMARK_CAPTURE(function, testmesh, std::string("testmesh.su2")); \
+	BENCHMARK_CAPTURE(function, naca0012_65x65, std::string("naca0012_euler_65x65x1_O_1B.su2"))
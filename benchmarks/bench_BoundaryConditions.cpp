@@ -0,0 +1,95 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#include "BenchCase.h"
+#include "solver/BoundaryConditions.h"
+#include <algorithm>
+
+using ees2d::bench::BenchCase;
+using ees2d::solver::ConvectiveFlux;
+using ees2d::solver::Solver;
+
+namespace {
+
+	// Inner element's rho, u, v, p, H (40), face elements (8), face vector and area (24), flux written (32)
+	constexpr size_t bytesPerFace = 104;
+
+	// Every BC function is timed on the faces of its boundary, whatever the local flow regime
+	template<class Condition>
+	void runCondition(benchmark::State &state, const std::string &meshName, const std::vector<uint32_t> BenchCase::*faces,
+	                  const Condition &condition) {
+		BenchCase &bench = ees2d::bench::benchCase(meshName);
+		ees2d::bench::setSyntheticState(bench);
+
+		const std::vector<uint32_t> &boundaryFaces = bench.*faces;
+		if (boundaryFaces.empty()) {
+			state.SkipWithError("no face of this boundary in the mesh");
+			return;
+		}
+
+		ees2d::mesh::Mesh &mesh = *bench.mesh;
+		Solver::faceParams faceP;
+		for (auto _ : state) {
+			for (auto &iface : boundaryFaces) {
+				const uint32_t elem1 = std::min(mesh.FaceToElem(iface, 0), mesh.FaceToElem(iface, 1));
+				ConvectiveFlux flux = condition(elem1, iface, faceP, *bench.sim, mesh);
+				benchmark::DoNotOptimize(flux);
+			}
+		}
+		ees2d::bench::setRates(state, boundaryFaces.size(), bytesPerFace, "faces/s");
+	}
+
+}// namespace
+
+//---------------------------------------------------------------
+static void BM_BC_wall(benchmark::State &state, const std::string &meshName) {
+	runCondition(state, meshName, &BenchCase::wallFaces, ees2d::solver::BC::wall);
+}
+EES2D_BENCHMARK_MESHES(BM_BC_wall);
+
+//---------------------------------------------------------------
+static void BM_BC_farfieldSupersonicInflow(benchmark::State &state, const std::string &meshName) {
+	runCondition(state, meshName, &BenchCase::farfieldFaces,
+	             [](const uint32_t &, const uint32_t &iface, Solver::faceParams &faceP, const ees2d::solver::Simulation &sim, ees2d::mesh::Mesh &mesh) {
+		             return ees2d::solver::BC::farfieldSupersonicInflow(iface, faceP, sim, mesh);
+	             });
+}
+EES2D_BENCHMARK_MESHES(BM_BC_farfieldSupersonicInflow);
+
+//---------------------------------------------------------------
+static void BM_BC_farfieldSupersonicOutflow(benchmark::State &state, const std::string &meshName) {
+	runCondition(state, meshName, &BenchCase::farfieldFaces, ees2d::solver::BC::farfieldSupersonicOutflow);
+}
+EES2D_BENCHMARK_MESHES(BM_BC_farfieldSupersonicOutflow);
+
+//---------------------------------------------------------------
+static void BM_BC_farfieldSubsonicInflow(benchmark::State &state, const std::string &meshName) {
+	runCondition(state, meshName, &BenchCase::farfieldFaces, ees2d::solver::BC::farfieldSubsonicInflow);
+}
+EES2D_BENCHMARK_MESHES(BM_BC_farfieldSubsonicInflow);
+
+//---------------------------------------------------------------
+static void BM_BC_farfieldSubsonicOutflow(benchmark::State &state, const std::string &meshName) {
+	runCondition(state, meshName, &BenchCase::farfieldFaces, ees2d::solver::BC::farfieldSubsonicOutflow);
+}
+EES2D_BENCHMARK_MESHES(BM_BC_farfieldSubsonicOutflow);
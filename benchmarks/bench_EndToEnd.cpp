@@ -0,0 +1,93 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#include "BenchCase.h"
+#include "post/postProcess.h"
+#include <iostream>
+#include <sstream>
+
+using ees2d::io::InputParser;
+using ees2d::mesh::Connectivity;
+using ees2d::mesh::Mesh;
+using ees2d::mesh::MetricsData;
+using ees2d::solver::Simulation;
+using ees2d::solver::Solver;
+
+// Whole run of the NACA0012 test case for a fixed number of iterations : parsing, preprocessing,
+// solver and coefficients. Every repetition starts again from the mesh file and the freestream,
+// so the CL and CD counters are the same on every run and can be checked against a baseline
+
+//---------------------------------------------------------------
+static void BM_NacaFixedIterations(benchmark::State &state, const std::string &meshName) {
+	const uint32_t iterations = state.range(0);
+
+	// Solver logs would break the benchmark table
+	std::ostringstream log;
+	std::streambuf *coutBuffer = std::cout.rdbuf(log.rdbuf());
+
+	std::string controlFile = std::string(EES2D_SOURCE_DIR) + "/tests/ControlFile.ees2d";
+	InputParser parameters(controlFile);
+	parameters.parse();
+	parameters.m_meshFile = std::string(EES2D_SOURCE_DIR) + "/tests/" + meshName;
+	parameters.m_threads = 1;
+	parameters.m_maxIter = iterations;
+	parameters.m_minResiudal = 0;// Never stop on convergence
+	parameters.m_outputResidual = "/dev/null";
+	parameters.m_outputPressure = "/dev/null";
+	parameters.m_historyFile.clear();
+	parameters.m_hardwareCounters = "FALSE";
+	parameters.m_loadBalanceReport = "FALSE";
+
+	double CL = 0;
+	double CD = 0;
+	uint32_t numElems = 0;
+	for (auto _ : state) {
+		log.str("");
+
+		ees2d::io::Su2Parser parser(parameters.m_meshFile);
+		parser.Parse();
+		Connectivity connectivity(parser);
+		connectivity.solve();
+		MetricsData metrics;
+		metrics.compute(connectivity);
+		Mesh mesh(connectivity, metrics);
+		Simulation sim(mesh, parameters);
+		Solver solver(sim, mesh);
+		solver.run();
+
+		ees2d::post::PostProcess post(mesh, sim);
+		post.solveCoefficients();
+
+		CL = sim.CL;
+		CD = sim.CD;
+		numElems = mesh.N_elems;
+	}
+	std::cout.rdbuf(coutBuffer);
+
+	state.counters["CL"] = CL;
+	state.counters["CD"] = CD;
+	state.counters["cell_iterations/s"] = benchmark::Counter(double(state.iterations()) * numElems * iterations, benchmark::Counter::kIsRate);
+}
+BENCHMARK_CAPTURE(BM_NacaFixedIterations, naca0012_65x65, std::string("naca0012_euler_65x65x1_O_1B.su2"))
+        ->Arg(100)
+        ->Unit(benchmark::kMillisecond);
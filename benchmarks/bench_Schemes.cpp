@@ -0,0 +1,68 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#include "BenchCase.h"
+#include "solver/Schemes.h"
+#include <algorithm>
+
+using ees2d::bench::BenchCase;
+using ees2d::solver::ConvectiveFlux;
+using ees2d::solver::Solver;
+
+namespace {
+
+	// Both elements' rho, u, v, p, H (80), face elements (8), face vector and area (24), flux written (32)
+	constexpr size_t bytesPerFace = 144;
+
+	template<class Scheme>
+	void runScheme(benchmark::State &state, const std::string &meshName, const Scheme &scheme) {
+		BenchCase &bench = ees2d::bench::benchCase(meshName);
+		ees2d::bench::setSyntheticState(bench);
+
+		ees2d::mesh::Mesh &mesh = *bench.mesh;
+		Solver::faceParams faceP;
+		for (auto _ : state) {
+			for (auto &iface : bench.interiorFaces) {
+				// Same element order as Solver::computeFaceFlux
+				const uint32_t elem1 = std::min(mesh.FaceToElem(iface, 0), mesh.FaceToElem(iface, 1));
+				const uint32_t elem2 = std::max(mesh.FaceToElem(iface, 0), mesh.FaceToElem(iface, 1));
+				ConvectiveFlux flux = scheme(elem1, elem2, iface, faceP, *bench.sim, mesh);
+				benchmark::DoNotOptimize(flux);
+			}
+		}
+		ees2d::bench::setRates(state, bench.interiorFaces.size(), bytesPerFace, "faces/s");
+	}
+
+}// namespace
+
+//---------------------------------------------------------------
+static void BM_RoeScheme(benchmark::State &state, const std::string &meshName) {
+	runScheme(state, meshName, ees2d::solver::scheme::RoeScheme);
+}
+EES2D_BENCHMARK_MESHES(BM_RoeScheme);
+
+//---------------------------------------------------------------
+static void BM_AveragingScheme(benchmark::State &state, const std::string &meshName) {
+	runScheme(state, meshName, ees2d::solver::scheme::AveragingScheme);
+}
+EES2D_BENCHMARK_MESHES(BM_AveragingScheme);
@@ -0,0 +1,78 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#include "BenchCase.h"
+#include "solver/TimeIntegration.h"
+
+using ees2d::bench::BenchCase;
+using ees2d::solver::ConservativeVariables;
+using ees2d::solver::Solver;
+
+// Element kernels of an iteration. The synthetic residuals and time steps are left untouched by
+// them, so every repetition does the same work
+
+//---------------------------------------------------------------
+static void BM_RK5(benchmark::State &state, const std::string &meshName) {
+	BenchCase &bench = ees2d::bench::benchCase(meshName);
+	ees2d::bench::setSyntheticState(bench);
+
+	const std::vector<ConservativeVariables> W0 = bench.sim->conservativeVariables;
+	const uint32_t numElems = bench.mesh->N_elems;
+	for (auto _ : state) {
+		ees2d::solver::TimeIntegration::RK5(*bench.sim, *bench.mesh, 0.0533, W0, 0, numElems);
+		benchmark::ClobberMemory();
+	}
+	// W0, residual, dt and area read (80), W written (32)
+	ees2d::bench::setRates(state, numElems, 112, "elems/s");
+}
+EES2D_BENCHMARK_MESHES(BM_RK5);
+
+//---------------------------------------------------------------
+static void BM_updateVariables(benchmark::State &state, const std::string &meshName) {
+	BenchCase &bench = ees2d::bench::benchCase(meshName);
+	ees2d::bench::setSyntheticState(bench);
+
+	const uint32_t numElems = bench.mesh->N_elems;
+	for (auto _ : state) {
+		bench.solver->updateVariables(0, numElems);
+		benchmark::ClobberMemory();
+	}
+	// W read (32), rho, u, v, E, p, H and Mach written (56)
+	ees2d::bench::setRates(state, numElems, 88, "elems/s");
+}
+EES2D_BENCHMARK_MESHES(BM_updateVariables);
+
+//---------------------------------------------------------------
+static void BM_findRms(benchmark::State &state, const std::string &meshName) {
+	BenchCase &bench = ees2d::bench::benchCase(meshName);
+	ees2d::bench::setSyntheticState(bench);
+
+	Solver::ResidualRMS rms(1, 1, 1, 1);
+	for (auto _ : state) {
+		bench.solver->findRms(rms);// Outside of a parallel region the worksharing loop runs on this thread alone
+		benchmark::DoNotOptimize(rms);
+	}
+	// Residual read (32)
+	ees2d::bench::setRates(state, bench.mesh->N_elems, 32, "elems/s");
+}
+EES2D_BENCHMARK_MESHES(BM_findRms);
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+# Performance regression gate : runs EES2D_bench (kernels and the fixed-iteration NACA0012 case)
+# and compares it to the committed baseline.json
+#
+#   compare_baseline.py path/to/EES2D_bench [--baseline baseline.json] [--time-tolerance 0.10]
+#                       [--coefficient-tolerance 1e-5] [--noise-floor 1000] [--repetitions 3] [--filter regex] [--update]
+#
+# A benchmark regresses when its median time is more than time-tolerance (relative) and more than
+# noise-floor nanoseconds (absolute, for the sub-microsecond kernels) above the baseline, or when one of its CL / CD counters moved by more than coefficient-tolerance (absolute).
+# Exit status : 0 no regression, 1 regression or missing benchmark, 2 the benchmark could not run.
+# Timings only mean something against a baseline of the same machine : regenerate it with --update
+
+import argparse
+import json
+import os
+import platform
+import subprocess
+import sys
+
+COEFFICIENTS = ("CL", "CD")
+TO_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def run_benchmarks(executable, repetitions, benchmark_filter):
+    command = [executable, "--benchmark_format=json", "--benchmark_repetitions=%d" % repetitions]
+    if repetitions > 1:
+        command.append("--benchmark_report_aggregates_only=true")
+    if benchmark_filter:
+        command.append("--benchmark_filter=" + benchmark_filter)
+
+    process = subprocess.run(command, stdout=subprocess.PIPE, universal_newlines=True)
+    if process.returncode != 0:
+        sys.exit("Error : %s exited with status %d" % (" ".join(command), process.returncode))
+    output = json.loads(process.stdout)
+
+    # Median of the repetitions, or the single run
+    results = {}
+    for entry in output["benchmarks"]:
+        if entry.get("error_occurred") or (repetitions > 1 and entry.get("aggregate_name") != "median"):
+            continue
+        result = {"real_time_ns": entry["real_time"] * TO_NS[entry["time_unit"]]}
+        for name in COEFFICIENTS:
+            if name in entry:
+                result[name] = entry[name]
+        results[entry["run_name"]] = result
+    return output["context"], results
+
+
+def write_baseline(path, context, results, time_tolerance, coefficient_tolerance):
+    baseline = {
+        "machine": {
+            "host_name": context.get("host_name", platform.node()),
+            "num_cpus": context.get("num_cpus"),
+            "mhz_per_cpu": context.get("mhz_per_cpu"),
+            "date": context.get("date"),
+        },
+        "time_tolerance": time_tolerance,
+        "coefficient_tolerance": coefficient_tolerance,
+        "benchmarks": results,
+    }
+    with open(path, "w") as stream:
+        json.dump(baseline, stream, indent=2, sort_keys=True)
+        stream.write("\n")
+
+
+def compare(baseline, results, time_tolerance, coefficient_tolerance, noise_floor):
+    regressions = 0
+    print("%-58s %14s %14s %9s  %s" % ("benchmark", "baseline (us)", "current (us)", "change", "status"))
+
+    for name in sorted(set(baseline) | set(results)):
+        if name not in results:
+            print("%-58s %14s %14s %9s  %s" % (name, "", "", "", "MISSING"))
+            regressions += 1
+            continue
+        current = results[name]
+        if name not in baseline:
+            print("%-58s %14s %14.2f %9s  %s" % (name, "", current["real_time_ns"] / 1e3, "", "new"))
+            continue
+        reference = baseline[name]
+
+        change = current["real_time_ns"] / reference["real_time_ns"] - 1
+        status = []
+        if change > time_tolerance and current["real_time_ns"] - reference["real_time_ns"] > noise_floor:
+            status.append("SLOWER")
+        for coefficient in COEFFICIENTS:
+            if coefficient in reference:
+                delta = abs(current.get(coefficient, float("nan")) - reference[coefficient])
+                if not delta <= coefficient_tolerance:
+                    status.append("%s %.6g (baseline %.6g)" % (coefficient, current.get(coefficient, float("nan")), reference[coefficient]))
+        if status:
+            regressions += 1
+
+        print("%-58s %14.2f %14.2f %+8.1f%%  %s" % (name, reference["real_time_ns"] / 1e3, current["real_time_ns"] / 1e3, 100 * change,
+                                                    ", ".join(status) if status else "ok"))
+    return regressions
+
+
+def main():
+    arguments = argparse.ArgumentParser(description="Compare EES2D_bench to the committed baseline")
+    arguments.add_argument("executable", help="EES2D_bench")
+    arguments.add_argument("--baseline", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "baseline.json"))
+    arguments.add_argument("--time-tolerance", type=float, help="allowed relative slowdown (default : from the baseline, or 0.10)")
+    arguments.add_argument("--coefficient-tolerance", type=float, help="allowed absolute CL / CD change (default : from the baseline, or 1e-5)")
+    arguments.add_argument("--noise-floor", type=float, default=1000, help="slowdowns below this many ns are ignored")
+    arguments.add_argument("--repetitions", type=int, default=3, help="runs of each benchmark, the median is compared")
+    arguments.add_argument("--filter", default="", help="only the benchmarks matching this regex")
+    arguments.add_argument("--update", action="store_true", help="write the current results as the new baseline")
+    options = arguments.parse_args()
+
+    baseline = {}
+    if os.path.exists(options.baseline):
+        with open(options.baseline) as stream:
+            baseline = json.load(stream)
+    elif not options.update:
+        print("Error : no baseline at %s (create it with --update)" % options.baseline, file=sys.stderr)
+        return 2
+
+    time_tolerance = options.time_tolerance if options.time_tolerance is not None else baseline.get("time_tolerance", 0.10)
+    coefficient_tolerance = (options.coefficient_tolerance
+                             if options.coefficient_tolerance is not None else baseline.get("coefficient_tolerance", 1e-5))
+
+    context, results = run_benchmarks(options.executable, options.repetitions, options.filter)
+
+    if options.update:
+        write_baseline(options.baseline, context, results, time_tolerance, coefficient_tolerance)
+        print("Baseline written : %s (%d benchmarks)" % (options.baseline, len(results)))
+        return 0
+
+    reference = baseline["benchmarks"]
+    if options.filter:
+        reference = {name: value for name, value in reference.items() if name in results}
+
+    regressions = compare(reference, results, time_tolerance, coefficient_tolerance, options.noise_floor)
+    print("\nTime tolerance : %+.1f%%, coefficient tolerance : %g" % (100 * time_tolerance, coefficient_tolerance))
+    if regressions:
+        print("%d regression(s) against %s" % (regressions, options.baseline))
+        return 1
+    print("No regression against %s" % options.baseline)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -23,22 +23,40 @@
  */
 
 #include "io/InputParser.h"
+#include "io/AsyncSolutionWriter.h"
+#include "io/GmshParser.h"
 #include "io/Su2Parser.h"
 #include "mesh/Connectivity.h"
 #include "mesh/Mesh.h"
+#include "mesh/MeshCache.h"
 #include "mesh/Metrics.h"
+#include "utils/MemoryReport.h"
+#include "utils/Profiler.h"
 #include "utils/Timer.h"
+#include "io/PointInterpolation.h"
+#include "io/PvtuWriter.h"
 #include "io/VtuWriter.h"
 #include <iostream>
+#include <memory>
+#include <omp.h>
 #include "solver/Simulation.h"
 #include "solver/Solver.h"
 #include "post/postProcess.h"
+using ees2d::io::AbstractParser;
+using ees2d::io::AsyncSolutionWriter;
+using ees2d::io::GmshParser;
 using ees2d::io::InputParser;
 using ees2d::io::Su2Parser;
 using ees2d::mesh::Connectivity;
 using ees2d::mesh::Mesh;
+using ees2d::mesh::MeshCache;
 using ees2d::mesh::MetricsData;
+using ees2d::utils::MemoryReport;
+using ees2d::utils::Profiler;
 using ees2d::utils::Timer;
+using ees2d::io::PointInterpolation;
+using ees2d::io::PvtuWriter;
+using ees2d::io::VtuFormat;
 using ees2d::io::VtuWriter;
 using ees2d::solver::Simulation;
 using ees2d::solver::Solver;
@@ -55,37 +73,121 @@ int main(int argc, char *argv[]) {
 	InputParser simulationParameters{inputFilePath};
 	simulationParameters.parse();
 
+	// Preprocessing (connectivity) uses the same number of threads as the solver
+	omp_set_num_threads(simulationParameters.m_threads);
 
-	Su2Parser parser(simulationParameters.m_meshFile);
-	parser.Parse();
 
-	Connectivity connectivity(parser);
-	connectivity.solve();
+	// Preprocessed mesh from the cache if it matches the mesh file, otherwise parse and solve it
+	const bool useCache = simulationParameters.m_meshCache == "TRUE";
+	MeshCache cache(simulationParameters.m_meshFile);
+	const bool cached = useCache && cache.open();
+
+	std::unique_ptr<AbstractParser> parser;
+	if (simulationParameters.m_meshFormat == "GMSH") {
+		parser = std::make_unique<GmshParser>(simulationParameters.m_meshFile);
+	} else if (simulationParameters.m_meshFormat == "SU2") {
+		parser = std::make_unique<Su2Parser>(simulationParameters.m_meshFile);
+	} else {
+		std::cerr << "Unknown mesh format : " << simulationParameters.m_meshFormat << std::endl;
+		exit(EXIT_FAILURE);
+	}
+
+	if (cached) {
+		cache.read(*parser);
+	} else {
+		parser->Parse();
+	}
+
+	// The cached tables are views into the cache file, it stays mapped as long as cache lives
+	Connectivity connectivity(*parser);
+	const bool cachedTables = cached && cache.read(connectivity);
+	if (!cachedTables) {
+		connectivity.solve();
+	}
 
 
 	MetricsData metrics;
-	metrics.compute(connectivity);
+	if (cachedTables) {
+		cache.read(metrics);
+	} else {
+		metrics.compute(connectivity);
+	}
+
+	if (useCache && !cachedTables) {
+		cache.write(*parser, connectivity, metrics);
+	}
 
 
 
 	Mesh mesh(connectivity, metrics);
 
+	// Memory held by the preprocessed mesh, before the solution arrays are allocated
+	MemoryReport meshMemory;
+	parser->reportMemory(meshMemory);
+	connectivity.reportMemory(meshMemory);
+	metrics.reportMemory(meshMemory);
+	meshMemory.report(std::cout, "preprocessing", mesh.N_elems);
+
 
   Simulation mysim(mesh,simulationParameters);
 
 
   Solver solver(mysim,mesh);
+
+	const VtuFormat format = VtuFormat::fromOptions(simulationParameters.m_outputEncoding, simulationParameters.m_outputCompression,
+	                                                simulationParameters.m_outputPrecision);
+	const bool vtkOutput = simulationParameters.m_outputFormat == "VTK" || simulationParameters.m_outputFormat == "PVTU";
+
+	// Node averaging weights, shared by every output
+	std::unique_ptr<PointInterpolation> interpolation;
+	if (vtkOutput && simulationParameters.m_outputPointData == "TRUE") {
+		interpolation = std::make_unique<PointInterpolation>(connectivity, mesh);
+	}
+
+	// Solution every OUTPUT_FREQUENCY iterations, written by a background thread while the solver goes on
+	std::unique_ptr<AsyncSolutionWriter> snapshotWriter;
+	const uint32_t outputFrequency = simulationParameters.m_outputFrequency;
+	if (vtkOutput && outputFrequency > 0) {
+		snapshotWriter = std::make_unique<AsyncSolutionWriter>(simulationParameters.m_outputFile, connectivity, mesh, mysim, format,
+		                                                       simulationParameters.m_outputFormat == "PVTU", simulationParameters.m_outputPieces);
+		snapshotWriter->setPointInterpolation(interpolation.get());
+		solver.setIterationCallback([&](uint32_t iteration) {
+			if (iteration % outputFrequency == 0) {
+				snapshotWriter->submit(iteration);
+			}
+		});
+	}
+
   solver.run();
+	if (snapshotWriter) {
+		snapshotWriter->finish();
+	}
 
 
   PostProcess mypost(mesh , mysim);
   mypost.solveCoefficients();
 
 	if (simulationParameters.m_outputFormat == "VTK"){
-		VtuWriter vtufile(simulationParameters.m_outputFile, connectivity, mesh,mysim);
+		VtuWriter vtufile(simulationParameters.m_outputFile, connectivity, mesh, mysim, format);
+		vtufile.setPointInterpolation(interpolation.get());
 		vtufile.writeSolution();
+	} else if (simulationParameters.m_outputFormat == "PVTU") {
+		PvtuWriter pvtufile(simulationParameters.m_outputFile, connectivity, mesh, mysim, format, simulationParameters.m_outputPieces);
+		pvtufile.setPointInterpolation(interpolation.get());
+		pvtufile.writeSolution();
 	}
 
+	MemoryReport runMemory = meshMemory;
+	mysim.reportMemory(runMemory);
+	solver.reportMemory(runMemory);
+	runMemory.report(std::cout, "end of run", mesh.N_elems);
+
+	if (Profiler::enabled) {
+		Profiler::report(std::cout);
+		if (!simulationParameters.m_profileFile.empty()) {
+			Profiler::writeTrace(simulationParameters.m_profileFile);
+		}
+	}
 
 	return 0;
 }
@@ -24,40 +24,81 @@
 
 #pragma once
 
+#include "utils/MemoryReport.h"
+#include <cstdlib>
 #include <fstream>
+#include <iostream>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <map>
 #include <vector>
 #include <unordered_map>
 
+namespace ees2d::mesh {
+	class MeshCache;
+}
+
 namespace ees2d::io {
 
 	class AbstractParser {
 		// Abstract class serving as an interface to other parser classes
+		friend class ees2d::mesh::MeshCache;// Fills the parsed data from a cache file instead of parsing
 
 public:
 		explicit AbstractParser(const std::string &path) : m_path(path){};
 		virtual ~AbstractParser(){};
 
 		// Pure virtual function to extract number of dimensions
-		virtual void parseDimensionInfo(std::ifstream &) = 0;
-		virtual void parseGridsInfo(std::ifstream &) = 0;
-		virtual void parseElementsInfo(std::ifstream &) = 0;
-		virtual void parseBoundaryConditionsInfo(std::ifstream &) = 0;
+		// Each one reads its section from the start of the buffer and moves the buffer past it
+		virtual void parseDimensionInfo(std::string_view &) = 0;
+		virtual void parseGridsInfo(std::string_view &) = 0;
+		virtual void parseElementsInfo(std::string_view &) = 0;
+		virtual void parseBoundaryConditionsInfo(std::string_view &) = 0;
 		virtual void Parse() = 0;
 
 		// Getters
-		inline const std::vector<std::tuple<double, double>> &get_coords() const { return m_COORDS; }
+		inline const std::vector<double> &get_x() const { return m_X; }
+		inline const std::vector<double> &get_y() const { return m_Y; }
 		inline const std::vector<uint32_t> &get_ElemIndex() { return m_ElemIndex; }
 		inline const std::vector<uint32_t> &get_NPSUE() { return m_NPSUE; }
 		inline const std::vector<uint32_t> &get_CONNEC() { return m_CONNEC; }
 		inline const std::vector<std::vector<uint32_t >> &get_boundaryConditions() { return m_boundaryConditions; }
+		inline const std::vector<std::string> &get_markerTags() const { return m_markerTags; }
+		inline const std::vector<uint32_t> &get_boundaryMarkers() const { return m_boundaryMarkers; }
 		inline const uint32_t &get_Ngrids() { return m_Ngrids; }
 		inline const uint32_t &get_Nelems() { return m_Nelems; }
 		inline uint32_t get_Nelems_copy() { return m_Nelems; }
 
+		// Bytes held by the parsed arrays
+		void reportMemory(ees2d::utils::MemoryReport &report) const {
+			report.addArray("parser", "x", m_X);
+			report.addArray("parser", "y", m_Y);
+			report.addArray("parser", "elemIds", m_ElemIds);
+			report.addArray("parser", "elemIndex", m_ElemIndex);
+			report.addArray("parser", "NPSUE", m_NPSUE);
+			report.addArray("parser", "CONNEC", m_CONNEC);
+			report.addArray("parser", "boundaryConditions", m_boundaryConditions);
+			report.addArray("parser", "boundaryMarkers", m_boundaryMarkers);
+			report.addArray("parser", "markerTags", m_markerTags);
+		}
+
+		// Boundary condition ID (BCID) of a marker tag, shared by every mesh format
+		static uint32_t boundaryConditionID(const std::string &tag) {
+			if (tag == "airfoil" || tag == "wall") {
+				return -1;
+			} else if (tag == "slipwall") {
+				return -2;
+			} else if (tag == "farfield") {
+				return -3;
+			} else if (tag == "condition4") {
+				return -4;
+			}
+			std::cerr << "Unknown boundary condition in mesh file : '" << tag << "' " << std::endl;
+			exit(EXIT_FAILURE);
+		}
+
 
 protected:
 		// class attributes
@@ -77,8 +118,15 @@ protected:
 		// Number of Boundaries (markers) in mesh file
 		uint32_t m_Nboundaries{0};
 
-		//m_COORDS --> Grid Coordinates = [{X1,Y1},{X2,Y2} ...]
-		std::vector<std::tuple<double, double>> m_COORDS;
+		//m_markerTags --> Name of each marker, in file order [TAG1, TAG2 ...]
+		std::vector<std::string> m_markerTags;
+
+		//m_boundaryMarkers --> Marker (position in m_markerTags) of each boundary edge, same order as m_boundaryConditions
+		std::vector<uint32_t> m_boundaryMarkers;
+
+		//m_X, m_Y --> Grid Coordinates = [X1, X2 ...], [Y1, Y2 ...]
+		std::vector<double> m_X;
+		std::vector<double> m_Y;
 
 		//m_ElemIds -- > Element id in same order as SU2 file [Element1_ID,Element2_ID...]
 		std::vector<uint32_t> m_ElemIds;
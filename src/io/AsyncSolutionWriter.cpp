@@ -0,0 +1,162 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+#include "io/AsyncSolutionWriter.h"
+#include "io/PvtuWriter.h"
+#include <fstream>
+#include <omp.h>
+
+using ees2d::io::AsyncSolutionWriter;
+using ees2d::mesh::Connectivity;
+using ees2d::mesh::Mesh;
+using ees2d::solver::Simulation;
+using std::ofstream, std::cout;
+
+
+AsyncSolutionWriter::AsyncSolutionWriter(const std::string &fileName, Connectivity &connectivity, Mesh &mesh, Simulation &sim,
+                                         const VtuFormat &format, bool pvtu, uint32_t numPieces)
+    : m_base(fileName), m_connectivity(connectivity), m_mesh(mesh), m_sim(sim), m_format(format), m_pvtu(pvtu), m_numPieces(numPieces) {
+
+	for (const std::string extension : {".pvtu", ".vtu"}) {
+		if (m_base.size() > extension.size() && m_base.compare(m_base.size() - extension.size(), extension.size(), extension) == 0) {
+			m_base.erase(m_base.size() - extension.size());
+			break;
+		}
+	}
+
+	// Pieces are counted here, the writer thread only has one OpenMP thread
+	if (m_numPieces == 0) {
+		m_numPieces = omp_get_max_threads();
+	}
+
+	m_thread = std::thread(&AsyncSolutionWriter::writerLoop, this);
+}
+
+//----------------------------------------------------------------
+AsyncSolutionWriter::~AsyncSolutionWriter() {
+	finish();
+}
+
+//----------------------------------------------------------------
+void AsyncSolutionWriter::submit(uint32_t iteration) {
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_condition.wait(lock, [&] { return m_pending == -1; });
+	const int slot = m_writing == 0 ? 1 : 0;
+	lock.unlock();
+
+	// The thread never touches a buffer that is neither pending nor being written
+	Snapshot &snapshot = m_buffers[slot];
+	snapshot.iteration = iteration;
+	snapshot.p.assign(m_sim.p.begin(), m_sim.p.end());
+	snapshot.rho.assign(m_sim.rho.begin(), m_sim.rho.end());
+	snapshot.Mach.assign(m_sim.Mach.begin(), m_sim.Mach.end());
+	snapshot.u.assign(m_sim.u.begin(), m_sim.u.end());
+	snapshot.v.assign(m_sim.v.begin(), m_sim.v.end());
+
+	lock.lock();
+	m_pending = slot;
+	m_condition.notify_all();
+}
+
+//----------------------------------------------------------------
+void AsyncSolutionWriter::finish() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_condition.notify_all();
+	if (m_thread.joinable()) {
+		m_thread.join();
+	}
+}
+
+//----------------------------------------------------------------
+void AsyncSolutionWriter::writerLoop() {
+	// The solver team already uses the cores : the parallel loops of the writers (pieces, zlib blocks)
+	// run serially on this thread instead of starting a second team that would oversubscribe them
+	omp_set_num_threads(1);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		m_condition.wait(lock, [&] { return m_pending != -1 || m_stop; });
+		if (m_pending == -1) {
+			break;// Stopped with nothing left to write
+		}
+
+		m_writing = m_pending;
+		m_pending = -1;
+		m_condition.notify_all();
+
+		lock.unlock();
+		write(m_buffers[m_writing]);
+		lock.lock();
+		m_writing = -1;
+	}
+}
+
+//----------------------------------------------------------------
+void AsyncSolutionWriter::write(Snapshot &snapshot) {
+
+	const CellFields fields{snapshot.p.data(), snapshot.rho.data(), snapshot.Mach.data(), snapshot.u.data(), snapshot.v.data()};
+	std::string fileName = m_base + "_" + std::to_string(snapshot.iteration) + ".vtu";
+
+	if (m_pvtu) {
+		PvtuWriter pvtufile(fileName, m_connectivity, m_mesh, m_sim, m_format, m_numPieces);
+		pvtufile.setCellFields(fields);
+		pvtufile.setPointInterpolation(m_interpolation);
+		pvtufile.writeSolution();
+		fileName = pvtufile.pvtuFileName();
+	} else {
+		VtuWriter vtufile(fileName, m_connectivity, m_mesh, m_sim, m_format);
+		vtufile.setCellFields(fields);
+		vtufile.setPointInterpolation(m_interpolation);
+		vtufile.writeSolution();
+	}
+
+	m_written.emplace_back(snapshot.iteration, fileName);
+	writeIndex();
+}
+
+//----------------------------------------------------------------
+void AsyncSolutionWriter::writeIndex() {
+	// Rewritten after each snapshot so it is valid even if the run is interrupted
+	// The iteration is the time step, files are referenced relative to the .pvd
+
+	ofstream fileStream(m_base + ".pvd");
+	fileStream << "<VTKFile type=\"Collection\" version=\"1.0\">"
+	           << "\n"
+	           << "<Collection>"
+	           << "\n";
+
+	for (auto &[iteration, fileName] : m_written) {
+		const size_t slash = fileName.find_last_of('/');
+		fileStream << "<DataSet timestep=\"" << iteration << "\" file=\"" << (slash == std::string::npos ? fileName : fileName.substr(slash + 1)) << "\"/>"
+		           << "\n";
+	}
+
+	fileStream << "</Collection>"
+	           << "\n"
+	           << "</VTKFile>";
+}
@@ -0,0 +1,88 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+#pragma once
+#include "io/VtuWriter.h"
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ees2d::io {
+
+class AsyncSolutionWriter {
+	// Solution files written during the iterations by a background thread. submit() copies the
+	// primitive arrays into one of two buffers and returns, the thread writes the other one meanwhile.
+	// "out.vtu" gives out_<iteration>.vtu (or .pvtu) files and the out.pvd time series listing them
+	public:
+	// pvtu : write each snapshot as .pvtu pieces instead of a single .vtu
+	AsyncSolutionWriter(const std::string& fileName, ees2d::mesh::Connectivity&, ees2d::mesh::Mesh&, ees2d::solver::Simulation&,
+	                    const VtuFormat&, bool pvtu = false, uint32_t numPieces = 0);
+	~AsyncSolutionWriter();
+
+	AsyncSolutionWriter(const AsyncSolutionWriter&) = delete;
+	AsyncSolutionWriter& operator=(const AsyncSolutionWriter&) = delete;
+
+	// Snapshot of the current solution, only waits if the two previous ones are not written yet
+	void submit(uint32_t iteration);
+	// Point data of the snapshots, see VtuWriter::setPointInterpolation. Set before the first submit()
+	inline void setPointInterpolation(const PointInterpolation* interpolation) { m_interpolation = interpolation; }
+	// Write what is left and stop the thread
+	void finish();
+
+	private:
+	struct Snapshot {
+		uint32_t iteration = 0;
+		std::vector<double> p;
+		std::vector<double> rho;
+		std::vector<double> Mach;
+		std::vector<double> u;
+		std::vector<double> v;
+	};
+
+	void writerLoop();
+	void write(Snapshot&);
+	void writeIndex();
+
+	std::string m_base;// Output file name without extension
+	ees2d::mesh::Connectivity& m_connectivity;
+	ees2d::mesh::Mesh& m_mesh;
+	ees2d::solver::Simulation& m_sim;
+	VtuFormat m_format;
+	bool m_pvtu;
+	uint32_t m_numPieces;
+	const PointInterpolation* m_interpolation = nullptr;
+
+	Snapshot m_buffers[2];
+	int m_pending = -1;// Buffer waiting for the thread
+	int m_writing = -1;// Buffer being written by the thread
+	bool m_stop = false;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::vector<std::pair<uint32_t, std::string>> m_written;// Iteration and file of each snapshot, for the .pvd
+	std::thread m_thread;
+};
+
+}
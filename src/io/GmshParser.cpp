@@ -0,0 +1,442 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+#include "GmshParser.h"
+#include "AbstractParser.h"
+#include "utils/MappedFile.h"
+#include "utils/Profiler.h"
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+using ees2d::io::GmshParser;
+using std::cout, std::endl, std::cerr;
+using std::swap;
+
+
+namespace {
+	// Next line of the buffer (without end of line characters), the buffer is moved past it
+	std::string_view nextLine(std::string_view &buffer) {
+		const size_t end = buffer.find('\n');
+		std::string_view line = buffer.substr(0, end);
+		buffer.remove_prefix(end == std::string_view::npos ? buffer.size() : end + 1);
+		if (!line.empty() && line.back() == '\r') {
+			line.remove_suffix(1);
+		}
+		return line;
+	}
+
+	inline bool isBlank(char c) {
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	inline bool startsWith(std::string_view line, std::string_view keyword) {
+		return line.substr(0, keyword.size()) == keyword;
+	}
+
+	class SectionReader {
+		// Numbers of a section, written as text in ASCII files and as raw values in binary files
+		// Binary sizes follow the MSH 4.1 format : int on 4 bytes, size_t and double on 8 bytes
+	public:
+		SectionReader(std::string_view &buffer, bool binary) : m_buffer(buffer), m_binary(binary) {}
+
+		template<class T>
+		T next() {
+			T value{};
+			nextBlock(&value, 1);
+			return value;
+		}
+
+		// count consecutive values, copied at once in binary files
+		template<class T>
+		void nextBlock(T *values, size_t count) {
+			if (m_binary) {
+				const size_t bytes = count * sizeof(T);
+				if (m_buffer.size() < bytes) {
+					fail();
+				}
+				std::memcpy(values, m_buffer.data(), bytes);
+				m_buffer.remove_prefix(bytes);
+				return;
+			}
+
+			for (size_t i = 0; i < count; i++) {
+				while (!m_buffer.empty() && isBlank(m_buffer.front())) {
+					m_buffer.remove_prefix(1);
+				}
+				auto [end, error] = std::from_chars(m_buffer.data(), m_buffer.data() + m_buffer.size(), values[i]);
+				if (error != std::errc()) {
+					fail();
+				}
+				m_buffer.remove_prefix(end - m_buffer.data());
+			}
+		}
+
+		// Skip the end of the section, up to and including its $EndSection line
+		void end(std::string_view endTag) {
+			while (!m_buffer.empty() && isBlank(m_buffer.front())) {
+				m_buffer.remove_prefix(1);
+			}
+			if (!startsWith(nextLine(m_buffer), endTag)) {
+				cerr << "Expected " << endTag << " in Gmsh mesh file !" << endl;
+				exit(EXIT_FAILURE);
+			}
+		}
+
+	private:
+		[[noreturn]] static void fail() {
+			cerr << "Invalid or truncated section in Gmsh mesh file !" << endl;
+			exit(EXIT_FAILURE);
+		}
+
+		std::string_view &m_buffer;
+		bool m_binary;
+	};
+}// namespace
+
+
+GmshParser::GmshParser(const std::string &path) : AbstractParser::AbstractParser(path) {
+
+	std::ifstream m_fileIO{m_path};
+
+	if (m_fileIO.is_open()) {
+		cout << "--------------------  Parsing Gmsh Mesh file !"
+		        " -----------------------"
+		     << endl;
+		m_proceed = true;
+	} else {
+		cerr << "Unable to open mesh file !" << endl;
+		exit(EXIT_FAILURE);
+	}
+}
+
+
+GmshParser::~GmshParser() {}
+
+
+void GmshParser::Parse() {
+	EES2D_PROFILE_ZONE("parse");
+	// Single pass over the memory mapped file. Sections are read in file order, $Nodes has to come
+	// before $Elements and sections that hold no mesh data ($Periodic, $NodeData ...) are skipped
+
+	if (m_proceed) {
+		ees2d::utils::MappedFile file(m_path);
+		if (!file.isOpen()) {
+			cerr << "Unable to open mesh file !" << endl;
+			exit(EXIT_FAILURE);
+		}
+
+		std::string_view buffer = file.view();
+		while (!buffer.empty()) {
+			const std::string_view line = nextLine(buffer);
+
+			if (line == "$MeshFormat") {
+				parseDimensionInfo(buffer);
+			} else if (line == "$PhysicalNames") {
+				parsePhysicalNames(buffer);
+			} else if (line == "$Entities") {
+				parseBoundaryConditionsInfo(buffer);
+			} else if (line == "$Nodes") {
+				parseGridsInfo(buffer);
+			} else if (line == "$Elements") {
+				parseElementsInfo(buffer);
+			} else if (startsWith(line, "$") && !startsWith(line, "$End")) {
+				const std::string endTag = "$End" + std::string(line.substr(1));
+				const size_t end = buffer.find(endTag);
+				buffer.remove_prefix(end == std::string_view::npos ? buffer.size() : end);
+				nextLine(buffer);
+			}
+		}
+
+		buildBoundaryConditions();
+	}
+}
+
+
+void GmshParser::parseDimensionInfo(std::string_view &buffer) {
+	// "version file-type data-size", followed by the integer 1 in binary files to check the byte order
+
+	std::string_view line = nextLine(buffer);
+	if (!startsWith(line, "4.1 ")) {
+		cerr << "Unsupported Gmsh mesh file version, expected 4.1 : '" << line << "'" << endl;
+		exit(EXIT_FAILURE);
+	}
+	line.remove_prefix(4);
+
+	SectionReader header(line, false);
+	const int fileType = header.next<int>();
+	const int dataSize = header.next<int>();
+	if (dataSize != sizeof(uint64_t)) {
+		cerr << "Unsupported Gmsh data size : " << dataSize << endl;
+		exit(EXIT_FAILURE);
+	}
+
+	m_binary = fileType == 1;
+	SectionReader reader(buffer, m_binary);
+	if (m_binary && reader.next<int32_t>() != 1) {
+		cerr << "Gmsh binary mesh file written with another byte order !" << endl;
+		exit(EXIT_FAILURE);
+	}
+	reader.end("$EndMeshFormat");
+
+	// Gmsh always writes 3 coordinates, the mesh is 2D unless it has volume elements
+	m_Ndim = 2;
+}
+
+
+void GmshParser::parsePhysicalNames(std::string_view &buffer) {
+	// Always ASCII : "numPhysicalNames" followed by one "dimension tag "name"" line per group
+
+	SectionReader reader(buffer, false);
+	const uint32_t numNames = reader.next<uint32_t>();
+
+	for (uint32_t i = 0; i < numNames; i++) {
+		const int dimension = reader.next<int>();
+		const int32_t tag = reader.next<int32_t>();
+
+		std::string_view line = nextLine(buffer);
+		const size_t first = line.find('"');
+		const size_t last = line.rfind('"');
+		if (first == std::string_view::npos || last == first) {
+			cerr << "Invalid physical name in Gmsh mesh file : '" << line << "'" << endl;
+			exit(EXIT_FAILURE);
+		}
+		if (dimension == 1) {
+			m_physicalNames[tag] = std::string(line.substr(first + 1, last - first - 1));
+		}
+	}
+	reader.end("$EndPhysicalNames");
+}
+
+
+void GmshParser::parseBoundaryConditionsInfo(std::string_view &buffer) {
+	// Number of points, curves, surfaces and volumes, then each entity with its physical groups
+	// Only the physical group of the curves is kept, it gives the boundary condition of their lines
+
+	SectionReader reader(buffer, m_binary);
+	const uint64_t numPoints = reader.next<uint64_t>();
+	const uint64_t numCurves = reader.next<uint64_t>();
+	const uint64_t numSurfaces = reader.next<uint64_t>();
+	const uint64_t numVolumes = reader.next<uint64_t>();
+
+	std::vector<int32_t> physicalTags;
+	double boundingBox[6];
+
+	// Point : tag, x, y, z, physical tags. Others : tag, bounding box, physical tags, bounding entities
+	for (uint64_t ientity = 0; ientity < numPoints + numCurves + numSurfaces + numVolumes; ientity++) {
+		const bool isPoint = ientity < numPoints;
+		const bool isCurve = !isPoint && ientity < numPoints + numCurves;
+
+		const int32_t tag = reader.next<int32_t>();
+		reader.nextBlock(boundingBox, isPoint ? 3 : 6);
+		physicalTags.resize(reader.next<uint64_t>());
+		reader.nextBlock(physicalTags.data(), physicalTags.size());
+		if (!isPoint) {
+			std::vector<int32_t> boundingEntities(reader.next<uint64_t>());
+			reader.nextBlock(boundingEntities.data(), boundingEntities.size());
+		}
+
+		if (isCurve && !physicalTags.empty()) {
+			m_curvePhysical[tag] = physicalTags[0];
+		}
+	}
+	reader.end("$EndEntities");
+}
+
+
+void GmshParser::parseGridsInfo(std::string_view &buffer) {
+	// "numEntityBlocks numNodes minNodeTag maxNodeTag", then for each entity block
+	// "entityDim entityTag parametric numNodesInBlock", the node tags and the coordinates of the block
+	// Node tags are renumbered from 0 in order of appearance
+
+	SectionReader reader(buffer, m_binary);
+	const uint64_t numBlocks = reader.next<uint64_t>();
+	const uint64_t numNodes = reader.next<uint64_t>();
+	reader.next<uint64_t>();
+	const uint64_t maxNodeTag = reader.next<uint64_t>();
+
+	m_Ngrids = numNodes;
+	cout << std::setw(40) << "Number of nodes : " << std::setw(6) << m_Ngrids << "\n";
+
+	m_X.resize(m_Ngrids);
+	m_Y.resize(m_Ngrids);
+	m_nodeIndex.assign(maxNodeTag + 1, uint32_t(-1));
+
+	std::vector<uint64_t> tags;
+	std::vector<double> coords;
+	uint32_t inode = 0;
+
+	for (uint64_t iblock = 0; iblock < numBlocks; iblock++) {
+		const int entityDim = reader.next<int32_t>();
+		reader.next<int32_t>();
+		const int parametric = reader.next<int32_t>();
+		const uint64_t blockSize = reader.next<uint64_t>();
+
+		// x, y, z followed by the parametric coordinates on the entity, if any
+		const size_t stride = 3 + (parametric ? entityDim : 0);
+		tags.resize(blockSize);
+		coords.resize(stride * blockSize);
+		reader.nextBlock(tags.data(), tags.size());
+		reader.nextBlock(coords.data(), coords.size());
+
+		if (inode + blockSize > m_Ngrids) {
+			cerr << "More nodes than announced in Gmsh mesh file !" << endl;
+			exit(EXIT_FAILURE);
+		}
+		for (uint64_t i = 0; i < blockSize; i++) {
+			if (tags[i] > maxNodeTag) {
+				cerr << "Invalid node tag in Gmsh mesh file : " << tags[i] << endl;
+				exit(EXIT_FAILURE);
+			}
+			m_nodeIndex[tags[i]] = inode;
+			m_X[inode] = coords[stride * i];
+			m_Y[inode] = coords[stride * i + 1];
+			inode++;
+		}
+	}
+	if (inode != m_Ngrids) {
+		cerr << "Fewer nodes than announced in Gmsh mesh file !" << endl;
+		exit(EXIT_FAILURE);
+	}
+	reader.end("$EndNodes");
+}
+
+
+uint32_t GmshParser::nodeIndex(uint64_t tag) const {
+	if (tag >= m_nodeIndex.size() || m_nodeIndex[tag] == uint32_t(-1)) {
+		cerr << "Unknown node tag in Gmsh mesh file : " << tag << endl;
+		exit(EXIT_FAILURE);
+	}
+	return m_nodeIndex[tag];
+}
+
+
+void GmshParser::parseElementsInfo(std::string_view &buffer) {
+	// "numEntityBlocks numElements minElementTag maxElementTag", then for each entity block
+	// "entityDim entityTag elementType numElementsInBlock" and one "elementTag nodeTags..." per element
+	// Elements of the surfaces are the mesh elements, lines of the curves the boundary edges
+
+	if (m_nodeIndex.empty()) {
+		cerr << "$Nodes must come before $Elements in Gmsh mesh file !" << endl;
+		exit(EXIT_FAILURE);
+	}
+
+	SectionReader reader(buffer, m_binary);
+	const uint64_t numBlocks = reader.next<uint64_t>();
+	const uint64_t numElements = reader.next<uint64_t>();
+	reader.next<uint64_t>();
+	reader.next<uint64_t>();
+
+	m_NPSUE.reserve(numElements);
+	m_CONNEC.reserve(3 * numElements);
+	m_ElemIndex.reserve(numElements + 1);
+	m_ElemIndex.push_back(0);
+
+	std::vector<uint64_t> data;
+
+	for (uint64_t iblock = 0; iblock < numBlocks; iblock++) {
+		const int entityDim = reader.next<int32_t>();
+		const int32_t entityTag = reader.next<int32_t>();
+		const int type = reader.next<int32_t>();
+		const uint64_t blockSize = reader.next<uint64_t>();
+
+		const uint32_t npoints = type >= 0 && size_t(type) < m_Gmsh_Element.size() ? m_Gmsh_Element[type] : 0;
+		if (npoints == 0) {
+			cerr << "Unsupported element type in Gmsh mesh file : " << type << endl;
+			exit(EXIT_FAILURE);
+		}
+		if (entityDim == 3) {
+			cerr << "Not a 2D mesh !" << endl;
+			exit(EXIT_FAILURE);
+		}
+
+		// Element tag followed by its node tags
+		const size_t stride = 1 + npoints;
+		data.resize(stride * blockSize);
+		reader.nextBlock(data.data(), data.size());
+
+		if (entityDim == 2) {
+			for (uint64_t i = 0; i < blockSize; i++) {
+				m_NPSUE.push_back(npoints);
+				for (uint32_t j = 0; j < npoints; j++) {
+					m_CONNEC.push_back(nodeIndex(data[stride * i + 1 + j]));
+				}
+				m_ElemIndex.push_back(m_CONNEC.size());
+			}
+		} else if (entityDim == 1 && npoints == 2) {
+			for (uint64_t i = 0; i < blockSize; i++) {
+				m_boundaryLines.push_back({entityTag, nodeIndex(data[stride * i + 1]), nodeIndex(data[stride * i + 2])});
+			}
+		}
+	}
+	reader.end("$EndElements");
+
+	m_Nelems = m_NPSUE.size();
+	cout << std::setw(40) << "Number of elements : " << std::setw(6) << m_Nelems << "\n";
+}
+
+
+void GmshParser::buildBoundaryConditions() {
+	// One marker per physical group, in order of first appearance of its lines
+
+	std::map<int32_t, uint32_t> markerOfPhysical;
+	std::vector<uint32_t> markerBCID;
+	std::vector<uint32_t> temp_first_node_pos = {};
+
+	for (auto &line : m_boundaryLines) {
+		auto curve = m_curvePhysical.find(line.curve);
+		if (curve == m_curvePhysical.end()) {
+			cerr << "Boundary curve " << line.curve << " has no physical group in Gmsh mesh file !" << endl;
+			exit(EXIT_FAILURE);
+		}
+
+		auto marker = markerOfPhysical.find(curve->second);
+		if (marker == markerOfPhysical.end()) {
+			auto name = m_physicalNames.find(curve->second);
+			if (name == m_physicalNames.end()) {
+				cerr << "Physical group " << curve->second << " has no name in Gmsh mesh file !" << endl;
+				exit(EXIT_FAILURE);
+			}
+			marker = markerOfPhysical.emplace(curve->second, m_markerTags.size()).first;
+			m_markerTags.push_back(name->second);
+			markerBCID.push_back(boundaryConditionID(name->second));
+		}
+
+		uint32_t grid_id = line.node1;
+		uint32_t grid_id2 = line.node2;
+		if (grid_id > grid_id2) {
+			swap(grid_id2, grid_id);
+		}
+		temp_first_node_pos.push_back(grid_id);
+		m_boundaryConditions.push_back({grid_id, grid_id2, markerBCID[marker->second]});
+		m_boundaryMarkers.push_back(marker->second);
+	}
+	m_boundaryConditions.push_back(temp_first_node_pos);
+
+	m_Nboundaries = m_markerTags.size();
+	cout << std::setw(40) << "Number of Boundaries (markers) : " << std::setw(6) << m_Nboundaries << "\n";
+}
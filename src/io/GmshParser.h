@@ -0,0 +1,73 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+#pragma once
+#include "AbstractParser.h"
+#include <array>
+#include <map>
+#include <unordered_map>
+
+
+namespace ees2d::io {
+
+	class GmshParser : public AbstractParser {
+		// Gmsh MSH 4.1 mesh file, ASCII or binary. Triangles and quadrilaterals of the surfaces are the
+		// elements, lines of the curves are the boundary edges. The boundary condition of a line is given
+		// by the name of the physical group of its curve (wall, farfield ...), z coordinates are ignored
+
+public:
+		explicit GmshParser(const std::string &path);
+		~GmshParser() override;
+
+		// All methods defined in AbstractParser.h
+		// Each one reads a section from just after its $Section line up to its $EndSection line
+		void parseDimensionInfo(std::string_view &) override;         // $MeshFormat
+		void parseGridsInfo(std::string_view &) override;             // $Nodes
+		void parseElementsInfo(std::string_view &) override;          // $Elements
+		void parseBoundaryConditionsInfo(std::string_view &) override;// $Entities
+		void Parse() override;
+
+private:
+		void parsePhysicalNames(std::string_view &);
+		void buildBoundaryConditions();
+		uint32_t nodeIndex(uint64_t tag) const;
+
+		// Number of nodes of each Gmsh element type (0 : not supported)
+		// 1 : line, 2 : triangle, 3 : quadrilateral, 15 : point
+		static constexpr std::array<uint32_t, 16> m_Gmsh_Element = {0, 2, 3, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1};
+
+		struct BoundaryLine {
+			int32_t curve;// Entity tag of the curve the line belongs to
+			uint32_t node1;
+			uint32_t node2;
+		};
+
+		bool m_binary = false;
+		std::map<int32_t, std::string> m_physicalNames;     // Name of each physical group of curves
+		std::unordered_map<int32_t, int32_t> m_curvePhysical;// Physical group of each curve entity
+		std::vector<uint32_t> m_nodeIndex;                   // Position in m_X, m_Y of each node tag
+		std::vector<BoundaryLine> m_boundaryLines;           // Lines in file order
+	};
+
+}// namespace ees2d::io
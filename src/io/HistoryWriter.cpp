@@ -0,0 +1,134 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+#include "io/HistoryWriter.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+using ees2d::io::HistoryWriter;
+
+
+HistoryWriter::HistoryWriter(const std::string &path, const std::vector<std::string> &columns, size_t blockSize)
+    : m_numColumns(columns.size()), m_blockSize(std::max<size_t>(blockSize, 1)), m_block(m_numColumns * m_blockSize) {
+
+	m_file = std::fopen(path.c_str(), "wb");
+	if (!m_file) {
+		std::cerr << "Unable to open history file : " << path << std::endl;
+		exit(EXIT_FAILURE);
+	}
+
+	const uint32_t numColumns = m_numColumns;
+	std::fwrite(magic, 1, sizeof(magic), m_file);
+	std::fwrite(&version, sizeof(version), 1, m_file);
+	std::fwrite(&numColumns, sizeof(numColumns), 1, m_file);
+	for (auto &column : columns) {
+		std::fwrite(column.c_str(), 1, column.size() + 1, m_file);
+	}
+}
+
+//----------------------------------------------------------------
+HistoryWriter::~HistoryWriter() {
+	flush();
+	std::fclose(m_file);
+}
+
+//----------------------------------------------------------------
+void HistoryWriter::append(const std::vector<double> &record) {
+	append(record.data(), record.size());
+}
+
+//----------------------------------------------------------------
+void HistoryWriter::append(const double *record, size_t count) {
+	for (size_t column = 0; column < m_numColumns; column++) {
+		m_block[column * m_blockSize + m_numRecords] = column < count ? record[column] : 0.0;
+	}
+	if (++m_numRecords == m_blockSize) {
+		flush();
+	}
+}
+
+//----------------------------------------------------------------
+void HistoryWriter::flush() {
+	if (m_numRecords == 0) {
+		return;
+	}
+
+	const uint64_t numRecords = m_numRecords;
+	std::fwrite(&numRecords, sizeof(numRecords), 1, m_file);
+	for (size_t column = 0; column < m_numColumns; column++) {
+		std::fwrite(m_block.data() + column * m_blockSize, sizeof(double), m_numRecords, m_file);
+	}
+	std::fflush(m_file);
+	m_numRecords = 0;
+}
+
+//----------------------------------------------------------------
+bool HistoryWriter::read(const std::string &path, std::vector<std::string> &columns, std::vector<std::vector<double>> &rows) {
+
+	std::unique_ptr<std::FILE, int (*)(std::FILE *)> file(std::fopen(path.c_str(), "rb"), &std::fclose);
+	if (!file) {
+		return false;
+	}
+
+	char fileMagic[sizeof(magic)];
+	uint32_t fileVersion = 0;
+	uint32_t numColumns = 0;
+	if (std::fread(fileMagic, 1, sizeof(fileMagic), file.get()) != sizeof(fileMagic) || std::memcmp(fileMagic, magic, sizeof(magic)) != 0 ||
+	    std::fread(&fileVersion, sizeof(fileVersion), 1, file.get()) != 1 || fileVersion != version ||
+	    std::fread(&numColumns, sizeof(numColumns), 1, file.get()) != 1) {
+		return false;
+	}
+
+	columns.assign(numColumns, "");
+	for (auto &column : columns) {
+		int c;
+		while ((c = std::fgetc(file.get())) > 0) {
+			column += char(c);
+		}
+		if (c == EOF) {
+			return false;
+		}
+	}
+
+	// A block cut by an interrupted run is dropped
+	rows.clear();
+	uint64_t numRecords = 0;
+	std::vector<double> block;
+	while (std::fread(&numRecords, sizeof(numRecords), 1, file.get()) == 1) {
+		block.resize(numRecords * numColumns);
+		if (std::fread(block.data(), sizeof(double), block.size(), file.get()) != block.size()) {
+			break;
+		}
+		for (uint64_t record = 0; record < numRecords; record++) {
+			std::vector<double> &row = rows.emplace_back(numColumns);
+			for (uint32_t column = 0; column < numColumns; column++) {
+				row[column] = block[column * numRecords + record];
+			}
+		}
+	}
+	return true;
+}
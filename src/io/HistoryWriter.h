@@ -0,0 +1,66 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace ees2d::io {
+
+class HistoryWriter {
+	// Convergence history in binary, one record (a fixed set of double columns) per iteration
+	// File : "EES2DHST", version (uint32), number of columns (uint32), column names (each ended by '\0'),
+	// then blocks of "number of records (uint64)" followed by the values of each column, column after column.
+	// Records are buffered in memory and written one block at a time
+	public:
+	HistoryWriter(const std::string& path, const std::vector<std::string>& columns, size_t blockSize = 512);
+	~HistoryWriter();
+
+	HistoryWriter(const HistoryWriter&) = delete;
+	HistoryWriter& operator=(const HistoryWriter&) = delete;
+
+	// One value per column, in the order of the constructor
+	void append(const std::vector<double>& record);
+	// Same from a fixed-size row, missing columns are 0
+	void append(const double* record, size_t count);
+	// Write the buffered records as one block
+	void flush();
+
+	// Whole history of a file written by HistoryWriter, one row per record. False if the file is not a history
+	static bool read(const std::string& path, std::vector<std::string>& columns, std::vector<std::vector<double>>& rows);
+
+	static constexpr char magic[8] = {'E', 'E', 'S', '2', 'D', 'H', 'S', 'T'};
+	static constexpr uint32_t version = 1;
+
+	private:
+	std::FILE* m_file = nullptr;
+	size_t m_numColumns;
+	size_t m_blockSize;
+	size_t m_numRecords = 0;   // Records in the buffer
+	std::vector<double> m_block;// Column c of record r at m_block[c * m_blockSize + r]
+};
+
+}
@@ -74,6 +74,9 @@ void InputParser::parse() {
 				else if (line.find("MESH_TYPE") != std::string::npos){
 					ss1.seekg(11) >> m_meshType;
 				}
+				else if (line.find("MESH_CACHE") != std::string::npos){
+					ss1.seekg(12) >> m_meshCache;
+				}
         else if (line.find("SPEED_OPTION") != std::string::npos){
           ss1.seekg(14) >> m_spdOption;
         }
@@ -125,9 +128,27 @@ void InputParser::parse() {
         else if (line.find("OPEMMP_THREADS_NUM") != std::string::npos){
           ss1.seekg(20) >> m_threads;
         }
+        else if (line.find("TILE_SIZE") != std::string::npos){
+          ss1.seekg(11) >> m_tileSize;
+        }
+        else if (line.find("SOLVER_SCHEDULE") != std::string::npos){
+          ss1.seekg(17) >> m_schedule;
+        }
+        else if (line.find("HARDWARE_COUNTERS") != std::string::npos){
+          ss1.seekg(19) >> m_hardwareCounters;
+        }
+        else if (line.find("LOAD_BALANCE_REPORT") != std::string::npos){
+          ss1.seekg(21) >> m_loadBalanceReport;
+        }
         else if (line.find("RESIDUAL_FILE") != std::string::npos){
           ss1.seekg(15) >> m_outputResidual;
         }
+        else if (line.find("HISTORY_FILE") != std::string::npos){
+          ss1.seekg(14) >> m_historyFile;
+        }
+        else if (line.find("PROFILE_FILE") != std::string::npos){
+          ss1.seekg(14) >> m_profileFile;
+        }
         else if (line.find("PRESSURE_FILE") != std::string::npos){
           ss1.seekg(15) >> m_outputPressure;
         }
@@ -137,6 +158,24 @@ void InputParser::parse() {
         else if (line.find("OUTPUT_FILE") != std::string::npos){
           ss1.seekg(13) >> m_outputFile;
         }
+        else if (line.find("OUTPUT_ENCODING") != std::string::npos){
+          ss1.seekg(17) >> m_outputEncoding;
+        }
+        else if (line.find("OUTPUT_COMPRESSION") != std::string::npos){
+          ss1.seekg(20) >> m_outputCompression;
+        }
+        else if (line.find("OUTPUT_PRECISION") != std::string::npos){
+          ss1.seekg(18) >> m_outputPrecision;
+        }
+        else if (line.find("OUTPUT_PIECES") != std::string::npos){
+          ss1.seekg(15) >> m_outputPieces;
+        }
+        else if (line.find("OUTPUT_FREQUENCY") != std::string::npos){
+          ss1.seekg(18) >> m_outputFrequency;
+        }
+        else if (line.find("OUTPUT_POINT_DATA") != std::string::npos){
+          ss1.seekg(19) >> m_outputPointData;
+        }
         else if (line.find("GENERATE_LOG") != std::string::npos){
           ss1.seekg(14) >> m_generateLog;
         }
@@ -155,6 +194,7 @@ void ees2d::io::InputParser::printAll() {
   std::cout << " m_meshFormat  "  <<m_meshFormat << "\n"
             << "m_meshFile     "  <<m_meshFile    << "\n"
             << "m_meshType     "  <<m_meshType    << "\n"
+            << "m_meshCache    "  <<m_meshCache   << "\n"
             << "m_spdOption    "  <<m_spdOption   << "\n"
             << "m_velocity     "  <<m_velocity    << "\n"
             << "m_Mach         "  <<m_Mach         << "\n"
@@ -168,7 +208,19 @@ void ees2d::io::InputParser::printAll() {
             << "m_scheme       "  <<m_scheme        << "\n"
             << "m_minResiudal  "  <<m_minResiudal   << "\n"
             << "m_threadsNum   "  <<m_threadsNum    << "\n"
+            << "m_tileSize     "  <<m_tileSize      << "\n"
+            << "m_schedule     "  <<m_schedule      << "\n"
+            << "m_hardwareCounters "  <<m_hardwareCounters << "\n"
+            << "m_loadBalanceReport "  <<m_loadBalanceReport << "\n"
             << "m_outputFormat " <<m_outputFormat << "\n"
             << "m_outputFile   "  <<m_outputFile    << "\n"
+            << "m_outputEncoding "  <<m_outputEncoding    << "\n"
+            << "m_outputCompression "  <<m_outputCompression << "\n"
+            << "m_outputPrecision "  <<m_outputPrecision   << "\n"
+            << "m_outputPieces "  <<m_outputPieces   << "\n"
+            << "m_outputFrequency "  <<m_outputFrequency   << "\n"
+            << "m_outputPointData "  <<m_outputPointData   << "\n"
+            << "m_historyFile  "  <<m_historyFile  << "\n"
+            << "m_profileFile  "  <<m_profileFile  << "\n"
             << "m_generateLog  "  <<m_generateLog  << "\n";
 }
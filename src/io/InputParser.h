@@ -37,9 +37,10 @@ public:
 		void printAll();
 
 		// Preprocessing variables
-		std::string m_meshFormat;
+		std::string m_meshFormat = "SU2";
 		std::string m_meshFile;
 		std::string m_meshType;
+		std::string m_meshCache = "FALSE";
 
 		// Simulation variables
 		std::string m_spdOption;
@@ -62,13 +63,25 @@ public:
 		double m_minResiudal = 0;
 		uint32_t m_maxIter = 0;
 		uint32_t m_threadsNum = 0;
+		uint32_t m_tileSize = 0;
+		std::string m_schedule = "TILES";
+		std::string m_hardwareCounters = "FALSE";
+		std::string m_loadBalanceReport = "FALSE";
 
 		// PostProcessing variables
 		std::string m_outputFormat;
 		std::string m_outputFile;
+		std::string m_outputEncoding = "ASCII";
+		std::string m_outputCompression = "NONE";
+		std::string m_outputPrecision = "FLOAT64";
+		uint32_t m_outputPieces = 0;
+		uint32_t m_outputFrequency = 0;
+		std::string m_outputPointData = "TRUE";
 		std::string m_generateLog;
 		std::string m_outputPressure;
 		std::string m_outputResidual;
+		std::string m_historyFile;
+		std::string m_profileFile;
 
 private:
 		std::string m_inputPath;
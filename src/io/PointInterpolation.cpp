@@ -0,0 +1,69 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+#include "io/PointInterpolation.h"
+#include <algorithm>
+#include <cmath>
+
+using ees2d::io::PointInterpolation;
+using ees2d::mesh::Connectivity;
+using ees2d::mesh::Mesh;
+
+
+PointInterpolation::PointInterpolation(Connectivity &connectivity, Mesh &mesh)
+    : m_esup2(connectivity.get_esup2()), m_esup1(connectivity.get_esup1()) {
+
+	const std::vector<double> &X = connectivity.get_parser().get_x();
+	const std::vector<double> &Y = connectivity.get_parser().get_y();
+	const uint32_t numNodes = connectivity.get_parser().get_Ngrids();
+	m_weights.resize(m_esup2[numNodes]);
+
+#pragma omp parallel for schedule(static) default(none) shared(numNodes, X, Y, mesh)
+	for (uint32_t inode = 0; inode < numNodes; inode++) {
+		double sum = 0;
+		for (uint32_t iesup = m_esup2[inode]; iesup < m_esup2[inode + 1]; iesup++) {
+			const auto &centroid = mesh.CvolumeCentroid(m_esup1[iesup]);
+			const double distance = std::hypot(centroid.x - X[inode], centroid.y - Y[inode]);
+			m_weights[iesup] = 1.0 / std::max(distance, 1e-300);
+			sum += m_weights[iesup];
+		}
+		for (uint32_t iesup = m_esup2[inode]; iesup < m_esup2[inode + 1]; iesup++) {
+			m_weights[iesup] /= sum;
+		}
+	}
+}
+
+//----------------------------------------------------------------
+void PointInterpolation::interpolate(const double *cellValues, const uint32_t *nodes, size_t numNodes, double *nodeValues) const {
+
+#pragma omp parallel for schedule(static) default(none) shared(cellValues, nodes, numNodes, nodeValues)
+	for (size_t i = 0; i < numNodes; i++) {
+		const uint32_t inode = nodes ? nodes[i] : i;
+		double value = 0;
+		for (uint32_t iesup = m_esup2[inode]; iesup < m_esup2[inode + 1]; iesup++) {
+			value += m_weights[iesup] * cellValues[m_esup1[iesup]];
+		}
+		nodeValues[i] = value;
+	}
+}
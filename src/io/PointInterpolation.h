@@ -0,0 +1,48 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+#pragma once
+#include "mesh/Mesh.h"
+#include <vector>
+
+namespace ees2d::io {
+
+class PointInterpolation {
+	// Cell to node averaging of the solution for the output, weighted by inverse distance :
+	// value(node) = sum over the elements e around the node of w(node, e) value(e), with
+	// w(node, e) = (1 / |x_node - x_e|) / sum(1 / |x_node - x_e'|), x_e the centroid of e
+	// The weights only depend on the mesh, they are computed once and reused by every output
+	public:
+	PointInterpolation(ees2d::mesh::Connectivity&, ees2d::mesh::Mesh&);
+
+	// nodeValues[i] = value at node nodes[i] (at node i when nodes is null), for i < numNodes
+	void interpolate(const double* cellValues, const uint32_t* nodes, size_t numNodes, double* nodeValues) const;
+
+	private:
+	sharedUintPtrArray m_esup2;// Start of the elements of each node in m_esup1 and m_weights
+	sharedUintPtrArray m_esup1;// Elements around each node
+	std::vector<double> m_weights;// Weight of each element around each node, in m_esup1 order
+};
+
+}
@@ -0,0 +1,137 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+#include "io/PvtuWriter.h"
+#include <algorithm>
+#include <fstream>
+#include <omp.h>
+
+using ees2d::io::PvtuWriter;
+using ees2d::mesh::Connectivity;
+using ees2d::mesh::Mesh;
+using ees2d::solver::Simulation;
+using std::ofstream, std::cout;
+
+
+PvtuWriter::PvtuWriter(const std::string &fileName, Connectivity &connectivity, Mesh &mesh, Simulation &sim, const VtuFormat &format, uint32_t numPieces)
+    : m_connectivity(connectivity), m_mesh(mesh), m_sim(sim), m_format(format),
+      m_fields{sim.p.data(), sim.rho.data(), sim.Mach.data(), sim.u.data(), sim.v.data()} {
+
+	std::string base = fileName;
+	for (const std::string extension : {".pvtu", ".vtu"}) {
+		if (base.size() > extension.size() && base.compare(base.size() - extension.size(), extension.size(), extension) == 0) {
+			base.erase(base.size() - extension.size());
+			break;
+		}
+	}
+	m_pvtuFileName = base + ".pvtu";
+
+	const uint32_t numElems = m_connectivity.get_parser().get_Nelems();
+	if (numPieces == 0) {
+		numPieces = omp_get_max_threads();
+	}
+	numPieces = std::max(1u, std::min(numPieces, numElems));
+
+	for (uint32_t ipiece = 0; ipiece <= numPieces; ipiece++) {
+		m_pieces.push_back(uint64_t(ipiece) * numElems / numPieces);
+	}
+	for (uint32_t ipiece = 0; ipiece < numPieces; ipiece++) {
+		m_pieceFileNames.push_back(base + "_" + std::to_string(ipiece) + ".vtu");
+	}
+}
+
+//----------------------------------------------------------------
+void PvtuWriter::writeSolution() {
+	// Pieces share nothing but read-only mesh and solution arrays, each thread writes whole pieces
+
+	const size_t numPieces = m_pieceFileNames.size();
+
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(numPieces)
+	for (size_t ipiece = 0; ipiece < numPieces; ipiece++) {
+		VtuWriter piece(m_pieceFileNames[ipiece], m_connectivity, m_mesh, m_sim, m_format);
+		piece.setPiece(m_pieces[ipiece], m_pieces[ipiece + 1]);
+		piece.setCellFields(m_fields);
+		piece.setPointInterpolation(m_interpolation);
+
+		ofstream fileStream(m_pieceFileNames[ipiece], std::ios::binary);
+		piece.beginFile(fileStream);
+		piece.writePoints(fileStream);
+		piece.writeCells(fileStream);
+		piece.writePointsData(fileStream);
+		piece.writeCellsData(fileStream);
+		piece.endFile(fileStream);
+	}
+
+	writeIndex();
+	cout << "Pvtu solution file generated (at " << m_pvtuFileName << " , " << numPieces << " pieces)" << std::endl;
+}
+
+//----------------------------------------------------------------
+void PvtuWriter::writeIndex() {
+	// Arrays as declared by VtuWriter, pieces referenced relative to the .pvtu file
+
+	const uint16_t one = 1;
+	const bool littleEndian = *reinterpret_cast<const uint8_t *>(&one) == 1;
+	const char *cellType = m_format.float32 ? "Float32" : "Float64";
+
+	ofstream fileStream(m_pvtuFileName);
+	fileStream << "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"" << (littleEndian ? "LittleEndian" : "BigEndian")
+	           << "\" header_type=\"UInt64\">"
+	           << "\n"
+	           << "<PUnstructuredGrid GhostLevel=\"0\">"
+	           << "\n"
+	           << "<PPoints>"
+	           << "\n"
+	           << "<PDataArray type=\"Float64\" NumberOfComponents=\"3\"/>"
+	           << "\n"
+	           << "</PPoints>"
+	           << "\n";
+
+	// Same arrays as point data and as cell data
+	for (const std::string data : {"PointData", "CellData"}) {
+		if (data == "PointData" && !m_interpolation) {
+			continue;
+		}
+		fileStream << "<P" << data << " Scalars=\"Pression\" Vectors=\"velocity\">"
+		           << "\n";
+		for (const char *name : {"Pression", "Density", "Mach"}) {
+			fileStream << "<PDataArray type=\"" << cellType << "\" Name=\"" << name << "\"/>"
+			           << "\n";
+		}
+		fileStream << "<PDataArray type=\"" << cellType << "\" Name=\"velocity\" NumberOfComponents=\"3\"/>"
+		           << "\n"
+		           << "</P" << data << ">"
+		           << "\n";
+	}
+
+	for (auto &pieceFileName : m_pieceFileNames) {
+		const size_t slash = pieceFileName.find_last_of('/');
+		fileStream << "<Piece Source=\"" << (slash == std::string::npos ? pieceFileName : pieceFileName.substr(slash + 1)) << "\"/>"
+		           << "\n";
+	}
+
+	fileStream << "</PUnstructuredGrid>"
+	           << "\n"
+	           << "</VTKFile>";
+}
@@ -0,0 +1,60 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+#pragma once
+#include "io/VtuWriter.h"
+#include <string>
+#include <vector>
+
+namespace ees2d::io {
+
+class PvtuWriter {
+	// Solution split in contiguous element ranges, each one written to its own .vtu piece by a separate
+	// thread, and the .pvtu file listing the pieces. "out.vtu" gives "out.pvtu", "out_0.vtu", "out_1.vtu" ...
+	public:
+	// numPieces = 0 : one piece per OpenMP thread
+	PvtuWriter(const std::string& fileName, ees2d::mesh::Connectivity&, ees2d::mesh::Mesh&, ees2d::solver::Simulation&,
+	           const VtuFormat& = VtuFormat(), uint32_t numPieces = 0);
+	void writeSolution();
+	inline void setCellFields(const CellFields& fields) { m_fields = fields; }
+	inline void setPointInterpolation(const PointInterpolation* interpolation) { m_interpolation = interpolation; }
+
+	inline const std::string& pvtuFileName() const { return m_pvtuFileName; }
+	inline const std::vector<std::string>& pieceFileNames() const { return m_pieceFileNames; }
+
+	private:
+	void writeIndex();
+
+	std::string m_pvtuFileName;
+	std::vector<std::string> m_pieceFileNames;
+	std::vector<uint32_t> m_pieces;// Element range boundaries of the pieces [0, e1, e2, ..., N_elems]
+	ees2d::mesh::Connectivity& m_connectivity;
+	ees2d::mesh::Mesh& m_mesh;
+	ees2d::solver::Simulation& m_sim;
+	VtuFormat m_format;
+	CellFields m_fields;
+	const PointInterpolation* m_interpolation = nullptr;
+};
+
+}
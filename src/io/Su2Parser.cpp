@@ -24,10 +24,13 @@
 
 #include "Su2Parser.h"
 #include "AbstractParser.h"
+#include "utils/MappedFile.h"
+#include "utils/Profiler.h"
+#include <charconv>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
-#include <sstream>
+#include <omp.h>
 #include <utility>
 
 using ees2d::io::Su2Parser;
@@ -35,6 +38,119 @@ using std::cout, std::endl, std::cerr;
 using std::swap;
 
 
+namespace {
+	// Next line of the buffer (without end of line characters), the buffer is moved past it
+	std::string_view nextLine(std::string_view &buffer) {
+		const size_t end = buffer.find('\n');
+		std::string_view line = buffer.substr(0, end);
+		buffer.remove_prefix(end == std::string_view::npos ? buffer.size() : end + 1);
+		if (!line.empty() && line.back() == '\r') {
+			line.remove_suffix(1);
+		}
+		return line;
+	}
+
+	// Read one number of the line, the line is moved past it
+	template<class T>
+	bool parseValue(std::string_view &line, T &value) {
+		while (!line.empty() && (line.front() == ' ' || line.front() == '\t')) {
+			line.remove_prefix(1);
+		}
+		auto [end, error] = std::from_chars(line.data(), line.data() + line.size(), value);
+		line.remove_prefix(end - line.data());
+		return error == std::errc();
+	}
+
+	// Text after "KEYWORD=" on a line, without surrounding blanks
+	std::string_view keywordValue(std::string_view line) {
+		line.remove_prefix(std::min(line.find('=') + 1, line.size()));
+		while (!line.empty() && (line.front() == ' ' || line.front() == '\t')) {
+			line.remove_prefix(1);
+		}
+		while (!line.empty() && (line.back() == ' ' || line.back() == '\t')) {
+			line.remove_suffix(1);
+		}
+		return line;
+	}
+
+	// Integer after "KEYWORD=" on a line
+	uint32_t keywordNumber(std::string_view line) {
+		std::string_view value = keywordValue(line);
+		uint32_t number = 0;
+		if (!parseValue(value, number)) {
+			cerr << "Invalid line in mesh file : '" << line << "'" << endl;
+			exit(EXIT_FAILURE);
+		}
+		return number;
+	}
+
+	// SU2 comments ('%') and blank lines hold no data
+	inline bool isDataLine(std::string_view line) {
+		const size_t start = line.find_first_not_of(" \t");
+		return start != std::string_view::npos && line[start] != '%';
+	}
+
+	// Next line holding data, the lines before it are skipped
+	std::string_view nextDataLine(std::string_view &buffer) {
+		while (!buffer.empty()) {
+			std::string_view line = nextLine(buffer);
+			if (isDataLine(line)) {
+				return line;
+			}
+		}
+		cerr << "Unexpected end of mesh file !" << endl;
+		exit(EXIT_FAILURE);
+	}
+
+	inline bool startsWith(std::string_view line, std::string_view keyword) {
+		return line.substr(0, keyword.size()) == keyword;
+	}
+
+	// The first count data lines of the buffer (comments included), the buffer is moved past them
+	std::string_view takeDataLines(std::string_view &buffer, size_t count) {
+		const char *begin = buffer.data();
+		while (count > 0) {
+			if (buffer.empty()) {
+				cerr << "Unexpected end of mesh file !" << endl;
+				exit(EXIT_FAILURE);
+			}
+			if (isDataLine(nextLine(buffer))) {
+				count--;
+			}
+		}
+		return {begin, size_t(buffer.data() - begin)};
+	}
+
+	// Split a block of lines in about numChunks pieces, each one made of whole lines
+	std::vector<std::string_view> splitLines(std::string_view block, size_t numChunks) {
+		std::vector<std::string_view> chunks;
+		const size_t chunkBytes = block.size() / std::max<size_t>(numChunks, 1) + 1;
+
+		while (!block.empty()) {
+			size_t end = std::min(chunkBytes, block.size());
+			end = block.find('\n', end - 1);
+			end = end == std::string_view::npos ? block.size() : end + 1;
+			chunks.push_back(block.substr(0, end));
+			block.remove_prefix(end);
+		}
+		return chunks;
+	}
+
+	// Pieces worth handing to separate threads : a few per thread, none smaller than 64 kB
+	size_t numChunks(std::string_view block) {
+		return std::min<size_t>(4 * omp_get_max_threads(), block.size() / (64 * 1024) + 1);
+	}
+
+	size_t countDataLines(std::string_view block) {
+		size_t count = 0;
+		while (!block.empty()) {
+			count += isDataLine(nextLine(block));
+		}
+		return count;
+	}
+}// namespace
+
+
 Su2Parser::Su2Parser(const std::string &path) : AbstractParser::AbstractParser(path) {
 
 	std::ifstream m_fileIO{m_path};
@@ -55,31 +171,56 @@ Su2Parser::~Su2Parser() {}
 
 
 void Su2Parser::Parse() {
+	EES2D_PROFILE_ZONE("parse");
+	// Single pass over the memory mapped file, each section reads its own lines and the
+	// keywords are dispatched in whatever order they appear in the file
 
 	if (m_proceed) {
-		std::ifstream m_fileIO(m_path);
-		parseDimensionInfo(m_fileIO);
-		parseGridsInfo(m_fileIO);
-		parseElementsInfo(m_fileIO);
-		parseBoundaryConditionsInfo(m_fileIO);
-	}
-}
-
-void Su2Parser::parseDimensionInfo(std::ifstream &m_fileIO) {
-	// Parse mesh dimension from SU2 file
-
-	std::string line;
-	while (std::getline(m_fileIO, line)) {
+		ees2d::utils::MappedFile file(m_path);
+		if (!file.isOpen()) {
+			cerr << "Unable to open mesh file !" << endl;
+			exit(EXIT_FAILURE);
+		}
 
-		if (line.find("NDIME") != std::string::npos) {
-			//Temporary stringstream to parse int from string
-			std::stringstream ss(line);
+		bool hasGrids = false;
+		bool hasElements = false;
+		std::string_view buffer = file.view();
+		while (!buffer.empty()) {
+			std::string_view section = buffer;
+			std::string_view line = nextLine(buffer);
+
+			if (startsWith(line, "NDIME")) {
+				parseDimensionInfo(section);
+			} else if (startsWith(line, "NPOIN")) {
+				parseGridsInfo(section);
+				hasGrids = true;
+			} else if (startsWith(line, "NELEM")) {
+				parseElementsInfo(section);
+				hasElements = true;
+			} else if (startsWith(line, "NMARK")) {
+				parseBoundaryConditionsInfo(section);
+			} else {
+				continue;
+			}
+			buffer = section;
+		}
 
-			//Begin at Pos num 6 to extract int : NDIME= ...
-			ss.seekg(6) >> m_Ndim;
-			break;
+		// A file without NDIME, NPOIN or NELEM would give an empty mesh
+		if (m_Ndim != 2) {
+			cerr << "Not a 2D mesh !" << endl;
+			exit(EXIT_FAILURE);
+		}
+		if (!hasGrids || !hasElements) {
+			cerr << "Unexpected end of mesh file !" << endl;
+			exit(EXIT_FAILURE);
 		}
 	}
+}
+
+void Su2Parser::parseDimensionInfo(std::string_view &buffer) {
+	// Parse mesh dimension from SU2 file : NDIME= ...
+
+	m_Ndim = keywordNumber(nextLine(buffer));
 
 	if (m_Ndim != 2) {
 		// Exit software if not a 2D mesh
@@ -90,161 +231,188 @@ void Su2Parser::parseDimensionInfo(std::ifstream &m_fileIO) {
 }
 
 
-void Su2Parser::parseGridsInfo(std::ifstream &m_fileIO) {
-	std::string line;
+void Su2Parser::parseGridsInfo(std::string_view &buffer) {
+	// NPOIN= ... followed by one "x y (ID)" line per node
+	// The lines are split in chunks parsed by separate threads, each chunk writes at the
+	// position given by the number of nodes in the chunks before it
 
-	m_fileIO.seekg(std::ifstream::beg);
-	while (std::getline(m_fileIO, line)) {
+	m_Ngrids = keywordNumber(nextLine(buffer));
+	cout << std::setw(40) << "Number of nodes : " << std::setw(6) << m_Ngrids << "\n";
 
-		if (line.find("NPOIN") != std::string::npos) {
-			//Temporary stringstream to parse int from string
-			std::stringstream ss1(line);
+	const std::string_view block = takeDataLines(buffer, m_Ngrids);
+	const std::vector<std::string_view> chunks = splitLines(block, numChunks(block));
+	const size_t nchunks = chunks.size();
 
-			//Begin at Pos num 6 to extract int : NPOIN = 2
-			ss1.seekg(6) >> m_Ngrids;
-			cout << std::setw(40) << "Number of nodes : " << std::setw(6) << m_Ngrids << "\n";
-			m_COORDS.reserve(m_Ngrids + 1);
-			double x, y;
+	std::vector<size_t> firstNode(nchunks + 1, 0);
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(chunks, nchunks, firstNode)
+	for (size_t ichunk = 0; ichunk < nchunks; ichunk++) {
+		firstNode[ichunk + 1] = countDataLines(chunks[ichunk]);
+	}
+	for (size_t ichunk = 0; ichunk < nchunks; ichunk++) {
+		firstNode[ichunk + 1] += firstNode[ichunk];
+	}
 
-			for (size_t i = 0; i < m_Ngrids; ++i) {
-				std::getline(m_fileIO, line);
-				std::stringstream ss1(line);
-				ss1 >> x >> y;
-				m_COORDS.push_back({x, y});
+	m_X.resize(m_Ngrids);
+	m_Y.resize(m_Ngrids);
+	bool valid = true;
+
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(chunks, nchunks, firstNode) reduction(&& : valid)
+	for (size_t ichunk = 0; ichunk < nchunks; ichunk++) {
+		std::string_view chunk = chunks[ichunk];
+		size_t inode = firstNode[ichunk];
+		while (!chunk.empty()) {
+			std::string_view line = nextLine(chunk);
+			if (isDataLine(line)) {
+				valid = parseValue(line, m_X[inode]) && parseValue(line, m_Y[inode]) && valid;
+				inode++;
 			}
-
-			break;
 		}
 	}
-}
 
+	if (!valid) {
+		cerr << "Invalid node coordinates in mesh file !" << endl;
+		exit(EXIT_FAILURE);
+	}
+}
 
-void Su2Parser::parseElementsInfo(std::ifstream &m_fileIO) {
-	std::string line;
 
-	// Setting m_fileIO back to the beginning the file
-	m_fileIO.seekg(m_fileIO.beg);
+void Su2Parser::parseElementsInfo(std::string_view &buffer) {
+	// NELEM= ... followed by one "VTK type, node IDs, (ID)" line per element
+	// Chunks of lines are parsed concurrently into their own arrays, then copied at the
+	// offsets given by a prefix sum of the number of elements and points of each chunk
+
+	m_Nelems = keywordNumber(nextLine(buffer));
+	cout << std::setw(40) << "Number of elements : " << std::setw(6) << m_Nelems << "\n";
+
+	const std::string_view block = takeDataLines(buffer, m_Nelems);
+	const std::vector<std::string_view> chunks = splitLines(block, numChunks(block));
+	const size_t nchunks = chunks.size();
+
+	struct ElementChunk {
+		std::vector<uint32_t> NPSUE;
+		std::vector<uint32_t> CONNEC;
+		uint32_t invalidType = 0;
+		bool valid = true;
+	};
+	std::vector<ElementChunk> parsed(nchunks);
+
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(chunks, nchunks, parsed)
+	for (size_t ichunk = 0; ichunk < nchunks; ichunk++) {
+		std::string_view chunk = chunks[ichunk];
+		ElementChunk &elements = parsed[ichunk];
+		// Assumed at least 3 points connected to each element, about 20 characters per line
+		elements.NPSUE.reserve(chunk.size() / 16);
+		elements.CONNEC.reserve(3 * (chunk.size() / 16));
+
+		while (!chunk.empty() && elements.valid) {
+			std::string_view line = nextLine(chunk);
+			if (!isDataLine(line)) {
+				continue;
+			}
 
-	while (std::getline(m_fileIO, line)) {
+			uint32_t type = 0;
+			parseValue(line, type);
+			const uint32_t npoints = type < m_Vtk_Cell.size() ? m_Vtk_Cell[type] : 0;
+			if (npoints == 0) {
+				elements.invalidType = type;
+				elements.valid = false;
+				break;
+			}
 
-		if (line.find("NELEM") != std::string::npos) {
+			elements.NPSUE.push_back(npoints);
+			for (uint32_t j = 0; j < npoints; ++j) {
+				uint32_t grid_id;
+				elements.valid = parseValue(line, grid_id) && elements.valid;
+				elements.CONNEC.push_back(grid_id);
+			}
+		}
+	}
 
-			//Temporary stringstream to parse int from string
-			std::stringstream ss(line);
+	// Prefix sum of the elements and points of each chunk
+	std::vector<size_t> firstElem(nchunks + 1, 0);
+	std::vector<size_t> firstPoint(nchunks + 1, 0);
+	for (size_t ichunk = 0; ichunk < nchunks; ichunk++) {
+		if (!parsed[ichunk].valid) {
+			if (parsed[ichunk].invalidType != 0) {
+				cerr << "Unsupported element type in mesh file : " << parsed[ichunk].invalidType << endl;
+			} else {
+				cerr << "Invalid element in mesh file !" << endl;
+			}
+			exit(EXIT_FAILURE);
+		}
+		firstElem[ichunk + 1] = firstElem[ichunk] + parsed[ichunk].NPSUE.size();
+		firstPoint[ichunk + 1] = firstPoint[ichunk] + parsed[ichunk].CONNEC.size();
+	}
 
-			//Begin at Pos num 6 to extract int : NELEM = ....
-			ss.seekg(6) >> m_Nelems;
-			cout << std::setw(40) << "Number of elements : " << std::setw(6) << m_Nelems << "\n";
+	m_NPSUE.resize(m_Nelems);
+	m_CONNEC.resize(firstPoint[nchunks]);
+	m_ElemIndex.resize(m_Nelems + 1);
+	m_ElemIndex[0] = 0;
+
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(nchunks, parsed, firstElem, firstPoint)
+	for (size_t ichunk = 0; ichunk < nchunks; ichunk++) {
+		const ElementChunk &elements = parsed[ichunk];
+		std::copy(elements.NPSUE.begin(), elements.NPSUE.end(), m_NPSUE.begin() + firstElem[ichunk]);
+		std::copy(elements.CONNEC.begin(), elements.CONNEC.end(), m_CONNEC.begin() + firstPoint[ichunk]);
+
+		uint32_t index_counter = firstPoint[ichunk];
+		for (size_t ielem = 0; ielem < elements.NPSUE.size(); ielem++) {
+			index_counter += elements.NPSUE[ielem];
+			m_ElemIndex[firstElem[ichunk] + ielem + 1] = index_counter;
+		}
+	}
+}
 
-			//Size is known for vectors,
-			// except m_CONnec, assumed at least 3 points connected to each element
-			m_ElemIndex.reserve(m_Nelems + 1);
-			m_ElemIndex.push_back(0);
-			m_NPSUE.reserve(m_Nelems + 1);
-			m_CONNEC.reserve(m_Nelems * 3);
 
-			uint32_t type;
-			uint32_t grid_id;
-			uint32_t index_counter = 0;
+void Su2Parser::parseBoundaryConditionsInfo(std::string_view &buffer) {
+	// NMARK= ... followed, for each marker, by MARKER_TAG= name, MARKER_ELEMS= N and N "type node1 node2" lines
 
-			for (uint32_t i = 0; i < m_Nelems; ++i) {
-				std::getline(m_fileIO, line);
-				std::stringstream ss(line);
-				ss >> type;
+	m_Nboundaries = keywordNumber(nextLine(buffer));
+	cout << std::setw(40) << "Number of Boundaries (markers) : " << std::setw(6) << m_Nboundaries << "\n";
 
-				m_NPSUE.push_back(m_Vtk_Cell[type]);
-				index_counter += m_Vtk_Cell[type];
-				m_ElemIndex.push_back(index_counter);
+	// Temporary variables to hold info of each SU2 mesh line
+	uint32_t N_boudaryelements;
+	uint32_t element_type;
+	uint32_t grid_id;
+	uint32_t grid_id2;
+	uint32_t boundary_id = 0;
+	std::vector<uint32_t> temp_first_node_pos = {};
 
-				for (uint32_t j = 0; j < m_Vtk_Cell[type]; ++j) {
-					ss >> grid_id;
+	// Loop though the number of Boundary Conditions (Tags)
+	for (size_t i = 0; i < m_Nboundaries; ++i) {
+		std::string_view line = nextDataLine(buffer);
 
-					m_CONNEC.push_back(grid_id);
-				}
-			}
-			break;
+		//parse Tag name
+		if (!startsWith(line, "MARKER_TAG")) {
+			cerr << "Expected MARKER_TAG in mesh file, found : '" << line << "'" << endl;
+			exit(EXIT_FAILURE);
 		}
-	}
-}
-
-
-void Su2Parser::parseBoundaryConditionsInfo(std::ifstream &m_fileIO) {
-	std::string line;
-
-	// Setting m_fileIO back to the beginning the file
-	m_fileIO.seekg(m_fileIO.beg);
-
-
-	while (std::getline(m_fileIO, line)) {
-
-		//entry condition to parse boundary info
-		if (line.find("NMARK") != std::string::npos) {
-			std::stringstream ss(line);
-			ss.seekg(6) >> m_Nboundaries;
-			cout << std::setw(40) << "Number of Boundaries (markers) : " << std::setw(6) << m_Nboundaries << "\n";
-
-			// Temporary variables to hold info of each SU2 mesh line
-			std::string boundary_tag;
-			uint32_t N_boudaryelements;
-			uint32_t element_type;
-			uint32_t grid_id;
-			uint32_t grid_id2;
-			uint32_t boundary_id =0;
-			std::vector<uint32_t> temp ={};
-      std::vector<uint32_t> temp_first_node_pos ={};
-
-			// Loop though the number of Boundary Conditions (Tags)
-			for (size_t i = 0; i < m_Nboundaries; ++i) {
-				std::getline(m_fileIO, line);
-
-				//parse Tag name
-				if (line.find("MARKER_TAG") != std::string::npos) {
-					std::stringstream ss(line);
-					ss.seekg(11) >> boundary_tag;
-					if(boundary_tag == "airfoil" || boundary_tag=="wall"){
-						boundary_id=-1;
-					}
-					else if(boundary_tag == "slipwall"){
-            boundary_id = -2;
-					}
-					else if(boundary_tag == "farfield"){
-            boundary_id = -3;
-					}
-					else if(boundary_tag == "condition4"){
-						boundary_id = -4;
-					}
-					else {
-						std::cerr << "Unknown boundary condition in mesh file : '" << boundary_tag << "' " <<std::endl;
-            exit(EXIT_FAILURE);
-					}
-					std::getline(m_fileIO, line);
-
-					// Parse Number of element in current looped tag
-					if (line.find("MARKER_ELEMS") != std::string::npos) {
-						std::stringstream ss(line);
-						ss.seekg(13) >> N_boudaryelements;
-
-
-						// Loop through Elements representing current Boundary condition (tag)
-						for (size_t j = 0; j < N_boudaryelements; ++j) {
-							temp = {};
-							std::getline(m_fileIO, line);
-							std::stringstream ss(line);
-							ss >> element_type >> grid_id >> grid_id2;
-							if (grid_id > grid_id2){
-								swap(grid_id2,grid_id);
-							}
-							temp_first_node_pos.push_back(grid_id);
-							temp.push_back(grid_id);
-							temp.push_back(grid_id2);
-							temp.push_back(boundary_id);
-							m_boundaryConditions.push_back(temp);
-						}
-					}
-				}
+		const std::string boundary_tag(keywordValue(line));
+		boundary_id = boundaryConditionID(boundary_tag);
+		m_markerTags.push_back(boundary_tag);
+
+		// Parse Number of element in current looped tag
+		line = nextDataLine(buffer);
+		if (!startsWith(line, "MARKER_ELEMS")) {
+			cerr << "Expected MARKER_ELEMS in mesh file, found : '" << line << "'" << endl;
+			exit(EXIT_FAILURE);
+		}
+		N_boudaryelements = keywordNumber(line);
+
+		// Loop through Elements representing current Boundary condition (tag)
+		for (size_t j = 0; j < N_boudaryelements; ++j) {
+			line = nextDataLine(buffer);
+			if (!parseValue(line, element_type) || !parseValue(line, grid_id) || !parseValue(line, grid_id2)) {
+				cerr << "Invalid boundary element in mesh file, marker " << boundary_tag << endl;
+				exit(EXIT_FAILURE);
 			}
-			m_boundaryConditions.push_back(temp_first_node_pos);
-			break;
+			if (grid_id > grid_id2) {
+				swap(grid_id2, grid_id);
+			}
+			temp_first_node_pos.push_back(grid_id);
+			m_boundaryConditions.push_back({grid_id, grid_id2, boundary_id});
+			m_boundaryMarkers.push_back(m_markerTags.size() - 1);
 		}
 	}
-}
\ No newline at end of file
+	m_boundaryConditions.push_back(temp_first_node_pos);
+}
@@ -24,6 +24,7 @@
 
 #pragma once
 #include "AbstractParser.h"
+#include <array>
 
 
 namespace ees2d::io {
@@ -35,19 +36,16 @@ public:
 		~Su2Parser() override;
 
 		// All methods defined in AbstractParser.h
-		void parseDimensionInfo(std::ifstream &) override;
-		void parseGridsInfo(std::ifstream &) override;
-		void parseElementsInfo(std::ifstream &) override;
-		void parseBoundaryConditionsInfo(std::ifstream &) override;
+		void parseDimensionInfo(std::string_view &) override;
+		void parseGridsInfo(std::string_view &) override;
+		void parseElementsInfo(std::string_view &) override;
+		void parseBoundaryConditionsInfo(std::string_view &) override;
 		void Parse() override;
 
 private:
-		// Unordered_map to define VTK_cells with following structure -> {vtk_cell_id : number_of_points}
-		std::unordered_map<uint32_t, uint32_t> m_Vtk_Cell = {
-		        {3, 2},
-		        {5, 3},
-		        {9, 4},
-		};
+		// Number of points of each VTK cell, indexed by VTK cell ID (0 : not supported)
+		// 3 : line (2 points), 5 : triangle (3 points), 9 : quadrilateral (4 points)
+		static constexpr std::array<uint32_t, 10> m_Vtk_Cell = {0, 0, 0, 2, 0, 3, 0, 0, 0, 4};
 	};
 
 }// namespace ees2d::io
\ No newline at end of file
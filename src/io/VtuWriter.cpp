@@ -23,23 +23,132 @@
  */
 
 #include "io/VtuWriter.h"
+#include "utils/Profiler.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <tuple>
+#ifdef EES2D_HAVE_ZLIB
+#include <zlib.h>
+#endif
 
+using ees2d::io::VtuFormat;
 using ees2d::io::VtuWriter;
 using ees2d::mesh::Connectivity;
 using ees2d::mesh::Mesh;
 using ees2d::solver::Simulation;
 using std::ofstream, std::cout;
 
-VtuWriter::VtuWriter(std::string &vtuFileName, Connectivity &connectivity, Mesh &mesh, Simulation& sim)
-    : m_vtuFileName(vtuFileName), m_connectivity(connectivity), m_mesh(mesh), m_sim(sim) {}
+
+namespace {
+	// VTK type name of the array values
+	template<class T> const char *vtkType();
+	template<> const char *vtkType<double>() { return "Float64"; }
+	template<> const char *vtkType<float>() { return "Float32"; }
+	template<> const char *vtkType<uint32_t>() { return "UInt32"; }
+	template<> const char *vtkType<uint8_t>() { return "UInt8"; }
+
+	// Uncompressed size of the zlib blocks, the one used by VTK
+	constexpr size_t blockSize = 32768;
+
+	std::string base64(const std::string &bytes) {
+		static constexpr char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		std::string encoded;
+		encoded.reserve((bytes.size() + 2) / 3 * 4);
+
+		size_t i = 0;
+		for (; i + 2 < bytes.size(); i += 3) {
+			const uint32_t word = uint8_t(bytes[i]) << 16 | uint8_t(bytes[i + 1]) << 8 | uint8_t(bytes[i + 2]);
+			encoded += table[word >> 18 & 63];
+			encoded += table[word >> 12 & 63];
+			encoded += table[word >> 6 & 63];
+			encoded += table[word & 63];
+		}
+		if (i < bytes.size()) {
+			const bool two = i + 1 < bytes.size();
+			const uint32_t word = uint8_t(bytes[i]) << 16 | (two ? uint8_t(bytes[i + 1]) << 8 : 0);
+			encoded += table[word >> 18 & 63];
+			encoded += table[word >> 12 & 63];
+			encoded += two ? table[word >> 6 & 63] : '=';
+			encoded += '=';
+		}
+		return encoded;
+	}
+
+	// Binary array as VTK reads it : a UInt64 header followed by the data
+	// The header gives the number of bytes, or the block sizes when the data is compressed
+	std::pair<std::string, std::string> encodeBinary(const char *data, size_t size, bool compress) {
+		std::vector<uint64_t> header;
+		std::string payload;
+
+		if (!compress) {
+			header.push_back(size);
+			payload.assign(data, size);
+		}
+#ifdef EES2D_HAVE_ZLIB
+		else {
+			// [number of blocks, block size, size of the last partial block (0 : full), compressed size of each block]
+			const size_t numBlocks = (size + blockSize - 1) / blockSize;
+			std::vector<std::string> blocks(numBlocks);
+
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(blocks, numBlocks, data, size, blockSize)
+			for (size_t iblock = 0; iblock < numBlocks; iblock++) {
+				const size_t begin = iblock * blockSize;
+				const size_t length = std::min(blockSize, size - begin);
+				uLongf compressedSize = compressBound(length);
+				blocks[iblock].resize(compressedSize);
+				compress2(reinterpret_cast<Bytef *>(blocks[iblock].data()), &compressedSize,
+				          reinterpret_cast<const Bytef *>(data + begin), length, Z_BEST_SPEED);
+				blocks[iblock].resize(compressedSize);
+			}
+
+			header = {numBlocks, blockSize, size % blockSize};
+			for (auto &block : blocks) {
+				header.push_back(block.size());
+				payload += block;
+			}
+		}
+#endif
+		return {std::string(reinterpret_cast<const char *>(header.data()), header.size() * sizeof(uint64_t)), payload};
+	}
+}// namespace
+
+
+VtuFormat VtuFormat::fromOptions(const std::string &encoding, const std::string &compression, const std::string &precision) {
+	VtuFormat format;
+
+	if (encoding == "BASE64") {
+		format.encoding = Encoding::BASE64;
+	} else if (encoding == "RAW") {
+		format.encoding = Encoding::RAW;
+	} else if (encoding != "ASCII") {
+		std::cerr << "Unknown output encoding : " << encoding << std::endl;
+		exit(EXIT_FAILURE);
+	}
+
+	format.compress = compression == "ZLIB" && format.encoding != Encoding::ASCII;
+#ifndef EES2D_HAVE_ZLIB
+	if (format.compress) {
+		std::cerr << "Built without zlib, the vtu file is written uncompressed" << std::endl;
+		format.compress = false;
+	}
+#endif
+
+	format.float32 = precision == "FLOAT32";
+	return format;
+}
+
+//----------------------------------------------------------------
+VtuWriter::VtuWriter(std::string &vtuFileName, Connectivity &connectivity, Mesh &mesh, Simulation& sim, const VtuFormat &format)
+    : m_vtuFileName(vtuFileName), m_connectivity(connectivity), m_mesh(mesh), m_sim(sim), m_format(format),
+      m_fields{sim.p.data(), sim.rho.data(), sim.Mach.data(), sim.u.data(), sim.v.data()},
+      m_lastElem(connectivity.get_parser().get_Nelems()) {}
 
 
 void VtuWriter::writeMesh() {
 
 
-	ofstream fileStream(m_vtuFileName);
+	ofstream fileStream(m_vtuFileName, std::ios::binary);
 	beginFile(fileStream);
 	writePoints(fileStream);
 	writeCells(fileStream);
@@ -51,10 +160,12 @@ void VtuWriter::writeMesh() {
 
 //----------------------------------------------------------------
 void VtuWriter::writeSolution() {
-	ofstream fileStream(m_vtuFileName);
+	EES2D_PROFILE_ZONE("write solution");
+	ofstream fileStream(m_vtuFileName, std::ios::binary);
 	beginFile(fileStream);
 	writePoints(fileStream);
 	writeCells(fileStream);
+	writePointsData(fileStream);
 	writeCellsData(fileStream);
 	endFile(fileStream);
 	fileStream.close();
@@ -66,151 +177,201 @@ void VtuWriter::writeSolution() {
 
 void VtuWriter::beginFile(ofstream &fileStream) {
 
-	fileStream << "<VTKFile type=\"UnstructuredGrid\">"
+	const uint16_t one = 1;
+	const bool littleEndian = *reinterpret_cast<const uint8_t *>(&one) == 1;
+
+	m_appended.clear();
+	fileStream << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"" << (littleEndian ? "LittleEndian" : "BigEndian")
+	           << "\" header_type=\"UInt64\"" << (m_format.compress ? " compressor=\"vtkZLibDataCompressor\"" : "") << ">"
 	           << "\n"
 	           << "<UnstructuredGrid>"
 	           << "\n"
-	           << "<Piece NumberOfPoints=\"" << m_connectivity.get_parser().get_Ngrids() << "\" NumberOfCells=\" " << m_connectivity.get_parser().get_Nelems() << "\">"
+	           << "<Piece NumberOfPoints=\"" << numPoints() << "\" NumberOfCells=\" " << m_lastElem - m_firstElem << "\">"
 	           << "\n";
 }
 
+//---------------------------------------------------------------
+template<class T>
+void VtuWriter::writeDataArray(ofstream &fileStream, const std::string &name, uint32_t components, const T *values, size_t count) {
+
+	fileStream << "<DataArray type=\"" << vtkType<T>() << "\"" << (name.empty() ? "" : " Name=\"" + name + "\"");
+	if (components > 1) {
+		fileStream << " NumberOfComponents=\"" << components << "\"";
+	}
+
+	if (m_format.encoding == VtuFormat::Encoding::ASCII) {
+		// One tuple per line for vectors, 10 values per line for scalars
+		const size_t perLine = components > 1 ? components : 10;
+		fileStream << " format=\"ascii\">"
+		           << "\n";
+		for (size_t i = 0; i < count; i++) {
+			fileStream << +values[i] << ((i + 1) % perLine == 0 ? "\n" : " ");
+		}
+		fileStream << "\n"
+		           << "</DataArray>"
+		           << "\n";
+		return;
+	}
+
+	auto [header, data] = encodeBinary(reinterpret_cast<const char *>(values), count * sizeof(T), m_format.compress);
+
+	if (m_format.encoding == VtuFormat::Encoding::BASE64) {
+		// Header and data are encoded separately, as VTK does
+		fileStream << " format=\"binary\">"
+		           << "\n"
+		           << base64(header) << base64(data) << "\n"
+		           << "</DataArray>"
+		           << "\n";
+	} else {
+		fileStream << " format=\"appended\" offset=\"" << m_appended.size() << "\"/>"
+		           << "\n";
+		m_appended += header;
+		m_appended += data;
+	}
+}
+
+//---------------------------------------------------------------
+void VtuWriter::writeCellArray(ofstream &fileStream, const std::string &name, uint32_t components, const double *values, size_t count) {
+	if (m_format.float32) {
+		const std::vector<float> singles(values, values + count);
+		writeDataArray(fileStream, name, components, singles.data(), count);
+	} else {
+		writeDataArray(fileStream, name, components, values, count);
+	}
+}
+
+//---------------------------------------------------------------
+void VtuWriter::setPiece(uint32_t firstElem, uint32_t lastElem) {
+	// Nodes of the piece in increasing order, their position in m_pieceNodes is their ID in the piece
+
+	m_firstElem = firstElem;
+	m_lastElem = lastElem;
+
+	const std::vector<uint32_t> &ElemIndex = m_connectivity.get_parser().get_ElemIndex();
+	const std::vector<uint32_t> &CONNEC = m_connectivity.get_parser().get_CONNEC();
+	m_pieceNodes.assign(CONNEC.begin() + ElemIndex[firstElem], CONNEC.begin() + ElemIndex[lastElem]);
+	std::sort(m_pieceNodes.begin(), m_pieceNodes.end());
+	m_pieceNodes.erase(std::unique(m_pieceNodes.begin(), m_pieceNodes.end()), m_pieceNodes.end());
+	m_wholeMesh = false;
+}
+
+//---------------------------------------------------------------
+uint32_t VtuWriter::numPoints() {
+	return m_wholeMesh ? m_connectivity.get_parser().get_Ngrids() : m_pieceNodes.size();
+}
+
 //---------------------------------------------------------------
 void VtuWriter::writePoints(ofstream &fileStream) {
 
+	const std::vector<double> &X = m_connectivity.get_parser().get_x();
+	const std::vector<double> &Y = m_connectivity.get_parser().get_y();
+	std::vector<double> coords(3 * numPoints(), 0.0);
+	for (size_t inode = 0; inode < numPoints(); inode++) {
+		const uint32_t node = m_wholeMesh ? inode : m_pieceNodes[inode];
+		coords[3 * inode] = X[node];
+		coords[3 * inode + 1] = Y[node];
+	}
+
 	fileStream << "<Points>"
-	           << "<DataArray type=\"Float64\" NumberOfComponents=\"3\" format=\"ascii\">"
 	           << "\n";
-	uint32_t returnline = 0;
-	for (auto &XY : m_connectivity.get_parser().get_coords()) {
-
-		fileStream << std::get<0>(XY) << " " << std::get<1>(XY) << " "
-		           << "0.0"
-		           << "\t";
-		returnline += 1;
-		if (returnline % 3 == 0) {
-			fileStream << "\n";
-		}
-	}
-	fileStream << "</DataArray>"
-	           << "\n"
-	           << "</Points>"
+	writeDataArray(fileStream, "", 3, coords.data(), coords.size());
+	fileStream << "</Points>"
 	           << "\n";
 }
 //---------------------------------------------------------------
 void VtuWriter::writeCells(ofstream &fileStream) {
 
-	std::unordered_map<uint32_t, uint32_t> m_Vtk_Cell = {
+	std::unordered_map<uint32_t, uint8_t> m_Vtk_Cell = {
 	        {2, 3},
 	        {3, 5},
 	        {4, 9},
 	};
 
+	const std::vector<uint32_t> &NPSUE = m_connectivity.get_parser().get_NPSUE();
+	const std::vector<uint32_t> &ElemIndex = m_connectivity.get_parser().get_ElemIndex();
+	const std::vector<uint32_t> &CONNEC = m_connectivity.get_parser().get_CONNEC();
+	const uint32_t numCells = m_lastElem - m_firstElem;
 
-	fileStream << "<Cells>"
-	           << "\n"
-	           << " <DataArray type=\"UInt32\" Name=\"connectivity\" format=\"ascii\">"
-	           << "\n";
-	uint32_t returnline = 0;
-
+	std::vector<uint32_t> offsets(numCells);
+	std::vector<uint8_t> types(numCells);
+	uint32_t offset = 0;
+	for (size_t icell = 0; icell < numCells; icell++) {
+		offset += NPSUE[m_firstElem + icell];
+		offsets[icell] = offset;
+		types[icell] = m_Vtk_Cell[NPSUE[m_firstElem + icell]];
+	}
 
-	for (auto &value : m_connectivity.get_parser().get_CONNEC()) {
-		fileStream << value << " ";
-		returnline += 1;
-		if (returnline % 9 == 0) {
-			fileStream << "\n";
+	// Node IDs of a piece are positions in m_pieceNodes
+	std::vector<uint32_t> pieceConnec;
+	if (!m_wholeMesh) {
+		pieceConnec.assign(CONNEC.begin() + ElemIndex[m_firstElem], CONNEC.begin() + ElemIndex[m_lastElem]);
+		for (auto &node : pieceConnec) {
+			node = std::lower_bound(m_pieceNodes.begin(), m_pieceNodes.end(), node) - m_pieceNodes.begin();
 		}
 	}
+	const std::vector<uint32_t> &connec = m_wholeMesh ? CONNEC : pieceConnec;
 
-
-	fileStream << "</DataArray>"
-	           << "\n"
-	           << "<DataArray type=\"UInt32\" Name=\"offsets\" format=\"ascii\">"
+	fileStream << "<Cells>"
 	           << "\n";
+	writeDataArray(fileStream, "connectivity", 1, connec.data(), connec.size());
+	writeDataArray(fileStream, "offsets", 1, offsets.data(), offsets.size());
+	writeDataArray(fileStream, "types", 1, types.data(), types.size());
+	fileStream << "</Cells>"
+	           << "\n";
+}
+//---------------------------------------------------------------
 
-	returnline = 0;
-
-	uint32_t offset = 0;
-	for (auto &value : m_connectivity.get_parser().get_NPSUE()) {
-		offset += value;
-		fileStream << offset << " ";
-		returnline += 1;
-		if (returnline % 10 == 0) {
-			fileStream << "\n";
-		}
+void VtuWriter::writePointsData(ofstream &fileStream) {
+	if (!m_interpolation) {
+		return;
 	}
 
-	returnline = 0;
+	const uint32_t count = numPoints();
+	const uint32_t *nodes = m_wholeMesh ? nullptr : m_pieceNodes.data();
+	std::vector<double> values(count);
 
-	fileStream << "</DataArray>"
-	           << "\n"
-	           << "<DataArray type=\"UInt8\" Name=\"types\" format=\"ascii\">"
+	fileStream << "<PointData Scalars=\"Pression\" Vectors=\"velocity\" >"
 	           << "\n";
 
-	for (auto &value : m_connectivity.get_parser().get_NPSUE()) {
-		fileStream << m_Vtk_Cell[value] << " ";
-		returnline += 1;
-		if (returnline % 10 == 0) {
-			fileStream << "\n";
-		}
+	for (auto &[name, field] : {std::make_pair("Pression", m_fields.p), std::make_pair("Density", m_fields.rho), std::make_pair("Mach", m_fields.Mach)}) {
+		m_interpolation->interpolate(field, nodes, count, values.data());
+		writeCellArray(fileStream, name, 1, values.data(), count);
 	}
 
-	fileStream << "</DataArray>"
-	           << "\n"
-	           << "</Cells>"
-	           << "\n";
-}
-//---------------------------------------------------------------
+	std::vector<double> velocity(3 * count, 0.0);
+	m_interpolation->interpolate(m_fields.u, nodes, count, values.data());
+	for (uint32_t i = 0; i < count; i++) {
+		velocity[3 * i] = values[i];
+	}
+	m_interpolation->interpolate(m_fields.v, nodes, count, values.data());
+	for (uint32_t i = 0; i < count; i++) {
+		velocity[3 * i + 1] = values[i];
+	}
+	writeCellArray(fileStream, "velocity", 3, velocity.data(), velocity.size());
 
-void VtuWriter::writePointsData(ofstream &) {
+	fileStream << "</PointData>"
+	           << "\n";
 }
 
 //---------------------------------------------------------------
 void VtuWriter::writeCellsData(ofstream &fileStream) {
 	fileStream << "<CellData Scalars=\"Pression\" Vectors=\"velocity\" >"
-	           << "\n"
-	           << "<DataArray type=\"Float64\" Name=\"Pression\" format=\"ascii\" >"
-	           << "\n";
-
-	uint32_t returnline = 0;
-	for (uint32_t i = 0; i < m_connectivity.get_parser().get_Nelems(); i++) {
-
-		fileStream << m_sim.p[i] << " ";
-		returnline += 1;
-		if (returnline % 10 == 0) {
-			fileStream << "\n";
-		}
-	}
-
-	fileStream << "</DataArray>"
-	           << "\n"
-			   << "<DataArray type=\"Float64\" Name=\"Density\" format=\"ascii\" >"
-	           << "\n";
-
-	for(uint32_t i=0; i < m_sim.rho.size();i++){
-		fileStream << (m_sim.rho[i])  << "\n";
-	}
-
-	fileStream << "</DataArray>"
-	           << "\n"
-			   << "<DataArray type=\"Float64\" Name=\"Mach\" format=\"ascii\" >"
 	           << "\n";
 
-	for(uint32_t i=0; i < m_sim.Mach.size();i++){
-		fileStream << (m_sim.Mach[i])  << "\n";
-	}
+	const uint32_t numCells = m_lastElem - m_firstElem;
+	writeCellArray(fileStream, "Pression", 1, m_fields.p + m_firstElem, numCells);
+	writeCellArray(fileStream, "Density", 1, m_fields.rho + m_firstElem, numCells);
+	writeCellArray(fileStream, "Mach", 1, m_fields.Mach + m_firstElem, numCells);
 
 	 // Ecriture des vitesses
-	fileStream << "</DataArray>"
-	           << "\n"
-			   << "<DataArray type=\"Float64\" Name=\"velocity\" format=\"ascii\" NumberOfComponents=\"3\" >"
-            << "\n";
-	for(uint32_t i=0; i < m_sim.u.size();i++){
-		fileStream << (m_sim.u[i]) << " " << m_sim.v[i] << " " << "0.0" << "\n";
+	std::vector<double> velocity(3 * numCells, 0.0);
+	for (uint32_t i = 0; i < numCells; i++) {
+		velocity[3 * i] = m_fields.u[m_firstElem + i];
+		velocity[3 * i + 1] = m_fields.v[m_firstElem + i];
 	}
+	writeCellArray(fileStream, "velocity", 3, velocity.data(), velocity.size());
 
-  fileStream << "</DataArray>"
-             << "\n"
-             << "</CellData>"
+  fileStream << "</CellData>"
              << "\n";
 
 }
@@ -220,6 +381,19 @@ void ees2d::io::VtuWriter::endFile(ofstream &fileStream) {
 	fileStream << "</Piece>"
 	           << "\n"
 	           << "</UnstructuredGrid>"
-	           << "\n"
-	           << "</VTKFile>";
-}
\ No newline at end of file
+	           << "\n";
+
+	// Raw arrays, their offsets count from the byte following the underscore
+	if (!m_appended.empty()) {
+		fileStream << "<AppendedData encoding=\"raw\">"
+		           << "\n"
+		           << "_";
+		fileStream.write(m_appended.data(), m_appended.size());
+		fileStream << "\n"
+		           << "</AppendedData>"
+		           << "\n";
+		m_appended.clear();
+	}
+
+	fileStream << "</VTKFile>";
+}
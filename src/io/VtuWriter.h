@@ -25,13 +25,37 @@
 #pragma once
 #include <string>
 #include <iostream>
+#include <vector>
 #include "mesh/Mesh.h"
 #include "solver/Simulation.h"
+#include "io/PointInterpolation.h"
 
 namespace ees2d::io {
+
+struct VtuFormat {
+	// How the data arrays are stored in the .vtu file
+	enum class Encoding { ASCII, BASE64, RAW };// RAW : binary arrays appended at the end of the file
+
+	Encoding encoding = Encoding::ASCII;
+	bool compress = false;// zlib blocks, binary encodings only
+	bool float32 = false; // Cell data in single precision (points are always Float64)
+
+	// From the OUTPUT_ENCODING, OUTPUT_COMPRESSION and OUTPUT_PRECISION options of the control file
+	static VtuFormat fromOptions(const std::string &encoding, const std::string &compression, const std::string &precision);
+};
+
+struct CellFields {
+	// Solution arrays written as cell data, one value per element
+	const double *p;
+	const double *rho;
+	const double *Mach;
+	const double *u;
+	const double *v;
+};
+
 class VtuWriter{
 	public:
-	VtuWriter(std::string& vtuFileName, ees2d::mesh::Connectivity&, ees2d::mesh::Mesh&, ees2d::solver::Simulation&);
+	VtuWriter(std::string& vtuFileName, ees2d::mesh::Connectivity&, ees2d::mesh::Mesh&, ees2d::solver::Simulation&, const VtuFormat& = VtuFormat());
 	void writeMesh();                                         // Writes only mesh without solution
 	void writePoints(std::ofstream&);
 	void writeCells(std::ofstream&);
@@ -41,11 +65,35 @@ class VtuWriter{
 	void writeCellsData(std::ofstream&);
 	void writeSolution();
 	// Writes mesh and solution at every element/node
+
+	// Restrict the file to elements [firstElem, lastElem) and the nodes they use (one piece of a .pvtu)
+	void setPiece(uint32_t firstElem, uint32_t lastElem);
+	// Write these arrays instead of those of the Simulation (a snapshot taken during the iterations)
+	inline void setCellFields(const CellFields& fields) { m_fields = fields; }
+	// Also write the solution averaged at the nodes as point data (nullptr : cell data only)
+	inline void setPointInterpolation(const PointInterpolation* interpolation) { m_interpolation = interpolation; }
   std::string m_vtuFileName;
 	ees2d::mesh::Connectivity& m_connectivity;
 
 	ees2d::mesh::Mesh& m_mesh;
 	ees2d::solver::Simulation& m_sim;
+
+	private:
+	// One <DataArray> of components values per tuple, in the encoding of m_format
+	template<class T>
+	void writeDataArray(std::ofstream&, const std::string& name, uint32_t components, const T* values, size_t count);
+	// Cell values, converted to single precision when asked
+	void writeCellArray(std::ofstream&, const std::string& name, uint32_t components, const double* values, size_t count);
+	uint32_t numPoints();
+
+	VtuFormat m_format;
+	CellFields m_fields;
+	const PointInterpolation* m_interpolation = nullptr;
+	uint32_t m_firstElem = 0;
+	uint32_t m_lastElem;
+	bool m_wholeMesh = true;
+	std::vector<uint32_t> m_pieceNodes;// Global ID of each node of the piece
+	std::string m_appended;// Binary data of the arrays written with Encoding::RAW, until endFile()
 };
 
-}
\ No newline at end of file
+}
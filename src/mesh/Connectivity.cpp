@@ -22,15 +22,29 @@
  * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
  */
 #include "mesh/Connectivity.h"
+#include "utils/Profiler.h"
 #include "utils/Timer.h"
 #include <algorithm>
+#include <array>
 #include <iomanip>
 #include <iostream>
-using ees2d::io::Su2Parser;
+#include <omp.h>
+#include <unordered_map>
+using ees2d::io::AbstractParser;
 using ees2d::mesh::Connectivity;
 
+namespace {
+	// Key of an edge in the boundary edge index, independent of the node order
+	inline uint64_t edgeKey(uint32_t node1, uint32_t node2) {
+		if (node1 > node2) {
+			std::swap(node1, node2);
+		}
+		return (uint64_t(node1) << 32) | node2;
+	}
+}// namespace
+
 
-Connectivity::Connectivity(Su2Parser &parser) : m_parser(parser) {
+Connectivity::Connectivity(AbstractParser &parser) : m_parser(parser) {
 
 	std::cout << " ---------------- Constructing connectivity tables !"
 	             " -----------------"
@@ -42,46 +56,45 @@ Connectivity::Connectivity(Su2Parser &parser) : m_parser(parser) {
 		m_esup1_size += val;
 	m_esup1 = std::make_unique<uint32_t[]>(m_esup1_size);
 
-	for (uint32_t i = 0; i < m_esup1_size; i++) {
-		m_esup1[i] = 0;
-	}
-
 	m_esup2_size = m_parser.get_Ngrids() + 1;
 	m_esup2 = std::make_unique<uint32_t[]>(m_esup2_size);
 
-	for (uint32_t i = 0; i < m_esup2_size; i++) {
-		m_esup2[i] = 0;
-	}
-
 	// Initializing points surrounding points arrays
 	m_psup2_size = m_parser.get_Ngrids() + 1;
-	m_lpoin_size = m_psup2_size - 1;
 	m_psup2 = std::make_unique<uint32_t[]>(m_psup2_size);
-	m_lpoin = new uint32_t[m_lpoin_size];// Temporary array to do calculations, not neeeded as retr
-	m_psup1.reserve(m_lpoin_size);       //Ngrids == m_lpoin_size
-
 
 	// Initializing Elements surrounding elements array
 	m_esuel_size = m_parser.get_Nelems();
-	m_elemToElem.reserve(m_esuel_size);
-
-	// Initializing Node Surrounding Face arrays
-	m_inpoe1 = new uint32_t[m_psup2_size];
 }
 
 //--------------------------------------------------------------------------
 
 void ees2d::mesh::Connectivity::solve() {
+	EES2D_PROFILE_ZONE("connectivity");
 	solveElemSurrNode();
 	solveNodeSurrNode();
 	solveElemSurrElem();
 	solveNodeSurrFace();
 	solveFaceSurrElem();
 	solveElemSurrFace();
-	delete[] m_inpoe1;
 	m_inpoe1 = nullptr;
-	delete[] m_lpoin;
-	m_lpoin = nullptr;
+	m_elemToElemFill = nullptr;
+	m_scratch.release();
+}
+
+//--------------------------------------------------------------------
+
+void Connectivity::reportMemory(ees2d::utils::MemoryReport &report) const {
+	report.add("connectivity", "esup1", ees2d::utils::MemoryReport::blockBytes(m_esup1_size * sizeof(uint32_t)));
+	report.add("connectivity", "esup2", ees2d::utils::MemoryReport::blockBytes(m_esup2_size * sizeof(uint32_t)));
+	report.addArray("connectivity", "psup1", m_psup1);
+	report.add("connectivity", "psup2", ees2d::utils::MemoryReport::blockBytes(m_psup2_size * sizeof(uint32_t)));
+	report.addArray("connectivity", "elemToElem", m_elemToElem);
+	report.addArray("connectivity", "faceToNode", m_faceToNode);
+	report.addArray("connectivity", "elemToFace", m_elemToFace);
+	report.addArray("connectivity", "faceToElem", m_faceToElem);
+	report.addArray("connectivity", "faceToMarker", m_faceToMarker);
+	report.add("connectivity", "scratch", m_scratch.capacity());// Empty once solve() has released it
 }
 
 //--------------------------------------------------------------------
@@ -93,19 +106,21 @@ const uint32_t &Connectivity::connecNodeSurrElement(const uint32_t &pointPos, co
 //-----------------------------------------------------------------------
 
 void Connectivity::solveElemSurrNode() {
+	EES2D_PROFILE_ZONE("solveElemSurrNode");
 
 	const uint32_t &Ngrids = m_parser.get_Ngrids();
 	const uint32_t &Nelems = m_parser.get_Nelems();
+	const std::vector<uint32_t> &NPSUE = m_parser.get_NPSUE();
 
-	uint32_t ipoi1 = 0;
-	uint32_t ipoin = 0;
-	uint32_t istor = 0;
+	std::fill(m_esup2.get(), m_esup2.get() + m_esup2_size, 0);
 
 	// Pass 1 : Count the number of elements connected to each point
+#pragma omp parallel for default(none) shared(Nelems, NPSUE)
 	for (uint32_t ielem = 0; ielem < Nelems; ielem++) {
-		for (uint32_t inode = 0; inode < m_parser.get_NPSUE()[ielem]; inode++) {
-			ipoi1 = connecNodeSurrElement(inode, ielem) + 1;
-			m_esup2[ipoi1] = m_esup2[ipoi1] + 1;
+		for (uint32_t inode = 0; inode < NPSUE[ielem]; inode++) {
+			const uint32_t ipoi1 = connecNodeSurrElement(inode, ielem) + 1;
+#pragma omp atomic
+			m_esup2[ipoi1] += 1;
 		}
 	}
 	// Reshuffling pass 1
@@ -113,127 +128,158 @@ void Connectivity::solveElemSurrNode() {
 		m_esup2[ipoin] = m_esup2[ipoin] + m_esup2[ipoin - 1];
 	}
 
-	// Calculate sum of NPSUE
-
-
-	//Pass 2 : Store the elements in m_esup1
-	for (uint32_t ielem = 0; ielem < Nelems; ielem++) {
-		for (uint32_t inode = 0; inode < m_parser.get_NPSUE()[ielem]; inode++) {
-			ipoin = connecNodeSurrElement(inode, ielem);
-			istor = m_esup2[ipoin] + 1;
-			m_esup2[ipoin] = istor;
-			m_esup1[istor - 1] = ielem;
+	//Pass 2 : Store the elements in m_esup1, each point has its own insertion cursor
+	uint32_t *cursor = m_scratch.allocate<uint32_t>(Ngrids);
+	std::copy(m_esup2.get(), m_esup2.get() + Ngrids, cursor);
+
+#pragma omp parallel default(none) shared(Ngrids, Nelems, NPSUE, cursor)
+	{
+#pragma omp for
+		for (uint32_t ielem = 0; ielem < Nelems; ielem++) {
+			for (uint32_t inode = 0; inode < NPSUE[ielem]; inode++) {
+				const uint32_t ipoin = connecNodeSurrElement(inode, ielem);
+				uint32_t istor;
+#pragma omp atomic capture
+				istor = cursor[ipoin]++;
+				m_esup1[istor] = ielem;
+			}
 		}
-	}
 
-	// Reshuffling pass 2
-	for (uint32_t ipoin = Ngrids; ipoin > 0; ipoin--) {
-		m_esup2[ipoin] = m_esup2[ipoin - 1];
+		// Threads insert in any order, sort back to increasing element IDs
+#pragma omp for schedule(dynamic, 1024)
+		for (uint32_t ipoin = 0; ipoin < Ngrids; ipoin++) {
+			std::sort(m_esup1.get() + m_esup2[ipoin], m_esup1.get() + m_esup2[ipoin + 1]);
+		}
 	}
-	m_esup2[0] = 0;
 
 	std::cout << std::setw(40) << "Node to Elem connectivity : " << std::setw(6) << "Done\n";
 }
 
 //--------------------------------------------------------------
 
-void Connectivity::solveNodeSurrNode() {
+uint32_t Connectivity::maxNodeDegree() {
+	const std::vector<uint32_t> &NPSUE = m_parser.get_NPSUE();
+	const uint32_t maxNodesPerElem = NPSUE.empty() ? 0 : *std::max_element(NPSUE.begin(), NPSUE.end());
 
-	for (uint32_t i = 0; i < m_lpoin_size; i++) {
-		m_lpoin[i] = 0;
+	uint32_t maxElems = 0;
+	for (uint32_t ipoin = 0; ipoin < m_parser.get_Ngrids(); ipoin++) {
+		maxElems = std::max(maxElems, m_esup2[ipoin + 1] - m_esup2[ipoin]);
 	}
+	return std::max(maxElems * maxNodesPerElem, 1u);
+}
 
-	m_psup2[0] = 0;
-	uint32_t istor = 0;
-	uint32_t ielem = 0;
-	uint32_t jpoin = 0;
+//--------------------------------------------------------------
 
-	for (uint32_t ipoin = 0; ipoin < m_parser.get_Ngrids(); ipoin++) {
+uint32_t Connectivity::collectNodeNeighbours(const uint32_t &ipoin, uint32_t *neighbours, bool edgesOnly) {
+	// Nodes are listed in the order they are met (element by element, local node by local node)
+	// The list of a node is short, a linear search is cheaper than a marker array per thread
+	uint32_t count = 0;
 
-		for (uint32_t iesup = m_esup2[ipoin]; iesup < m_esup2[ipoin + 1]; iesup++) {
-			ielem = m_esup1[iesup];
+	for (uint32_t iesup = m_esup2[ipoin]; iesup < m_esup2[ipoin + 1]; iesup++) {
+		const uint32_t ielem = m_esup1[iesup];
+		const uint32_t nnode = m_parser.get_NPSUE()[ielem];
 
-			for (uint32_t inode = 0; inode < m_parser.get_NPSUE()[ielem]; inode++) {
-				jpoin = connecNodeSurrElement(inode, ielem);
-				if ((jpoin != ipoin) && (m_lpoin[jpoin] != ipoin || ipoin == 0)) {
-					istor += 1;
-					m_psup1.push_back(jpoin);
-					m_lpoin[jpoin] = ipoin;
-				}
+		uint32_t local = 0;
+		while (connecNodeSurrElement(local, ielem) != ipoin) {
+			local++;
+		}
+
+		for (uint32_t inode = 0; inode < nnode; inode++) {
+			const uint32_t jpoin = connecNodeSurrElement(inode, ielem);
+			if (jpoin == ipoin) {
+				continue;
+			}
+			// Edges only link consecutive local nodes, and are stored once by their lowest node
+			if (edgesOnly && (jpoin < ipoin || (inode != (local + 1) % nnode && (inode + 1) % nnode != local))) {
+				continue;
+			}
+			if (std::find(neighbours, neighbours + count, jpoin) == neighbours + count) {
+				neighbours[count++] = jpoin;
 			}
 		}
-		m_psup2[ipoin + 1] = istor;
 	}
-	std::cout << std::setw(40) << "Node to node connectivity : " << std::setw(6) << "Done\n";
+	return count;
 }
 
-//------------------------------------------------------------------
-
-void Connectivity::solveElemSurrElem() {
+//--------------------------------------------------------------
 
-	uint32_t nnofa = 2;// Always two nodes per face (2D)
-	std::array<uint32_t, 2> lhelp;
-	uint32_t ipoin = 0;
-	uint32_t jelem = 0;
-	uint32_t nnofj = 2;
-	uint32_t icoun = 0;
-	uint32_t jpoin = 0;
+void Connectivity::solveNodeSurrNode() {
+	EES2D_PROFILE_ZONE("solveNodeSurrNode");
 
-	std::vector<std::vector<uint32_t>> m_lpofa3 = {{0, 1},
-	                                               {1, 2},
-	                                               {2, 0}};
+	const uint32_t &Ngrids = m_parser.get_Ngrids();
+	const uint32_t maxDegree = maxNodeDegree();
+	uint32_t *neighbours = m_scratch.allocate<uint32_t>(size_t(maxDegree) * omp_get_max_threads());
 
-	std::vector<std::vector<uint32_t>> m_lpofa4 = {{0, 1},
-	                                               {1, 2},
-	                                               {2, 3},
-	                                               {3, 0}};
+	// Pass 1 : Count the neighbours of each node
+	m_psup2[0] = 0;
+#pragma omp parallel default(none) shared(Ngrids, maxDegree, neighbours)
+	{
+		uint32_t *local = neighbours + size_t(maxDegree) * omp_get_thread_num();
+#pragma omp for schedule(dynamic, 1024)
+		for (uint32_t ipoin = 0; ipoin < Ngrids; ipoin++) {
+			m_psup2[ipoin + 1] = collectNodeNeighbours(ipoin, local, false);
+		}
+	}
 
-	std::vector<std::vector<uint32_t>> *m_lpofa;
+	for (uint32_t ipoin = 1; ipoin < m_psup2_size; ipoin++) {
+		m_psup2[ipoin] += m_psup2[ipoin - 1];
+	}
 
-	for (uint32_t i = 0; i < m_lpoin_size; i++) {
-		m_lpoin[i] = 0;
+	// Pass 2 : Each node writes its neighbours directly at its place in m_psup1
+	m_psup1.resize(m_psup2[Ngrids]);
+#pragma omp parallel for schedule(dynamic, 1024) default(none) shared(Ngrids)
+	for (uint32_t ipoin = 0; ipoin < Ngrids; ipoin++) {
+		collectNodeNeighbours(ipoin, m_psup1.data() + m_psup2[ipoin], false);
 	}
 
-	for (uint32_t ielem = 0; ielem < m_parser.get_Nelems(); ielem++) {
+	std::cout << std::setw(40) << "Node to node connectivity : " << std::setw(6) << "Done\n";
+}
+
+//------------------------------------------------------------------
+
+bool Connectivity::hasEdge(const uint32_t &elementID, const uint32_t &node1, const uint32_t &node2) const {
+	const uint32_t nnode = m_parser.get_NPSUE()[elementID];
 
-		std::vector<uint32_t> temp_surr_elem = {};
-		if (m_parser.get_NPSUE()[ielem] == 3) {
-			m_lpofa = &m_lpofa3;
-		} else if (m_parser.get_NPSUE()[ielem] == 4) {
-			m_lpofa = &m_lpofa4;
+	for (uint32_t ifael = 0; ifael < nnode; ifael++) {
+		const uint32_t ipoi1 = connecNodeSurrElement(ifael, elementID);
+		const uint32_t ipoi2 = connecNodeSurrElement((ifael + 1) % nnode, elementID);
+		if ((ipoi1 == node1 && ipoi2 == node2) || (ipoi1 == node2 && ipoi2 == node1)) {
+			return true;
 		}
+	}
+	return false;
+}
+
+//------------------------------------------------------------------
 
-		for (uint32_t ifael = 0; ifael < m_parser.get_NPSUE()[ielem]; ifael++) {
+void Connectivity::solveElemSurrElem() {
+	EES2D_PROFILE_ZONE("solveElemSurrElem");
 
-			for (uint32_t nnofa = 0; nnofa < 2; nnofa++) {
-				lhelp[nnofa] = connecNodeSurrElement((*m_lpofa)[ifael][nnofa], ielem);
-				m_lpoin[lhelp[nnofa]] = 1;
-			}
-			ipoin = lhelp[0];
-
-			for (uint32_t istor = m_esup2[ipoin]; istor < m_esup2[ipoin + 1]; istor++) {
-				jelem = m_esup1[istor];
-
-				if (jelem != ielem) {
-					for (uint32_t jfael = 0; jfael < m_parser.get_NPSUE()[ielem]; jfael++) {
-						if (nnofj == nnofa) {
-							icoun = 0;
-							for (uint32_t jnofa = 0; jnofa < nnofa; jnofa++) {
-								jpoin = connecNodeSurrElement((*m_lpofa)[jfael][jnofa], jelem);
-								icoun = icoun + m_lpoin[jpoin];
-							}
-							if (icoun == nnofa) {
-								temp_surr_elem.push_back(jelem);
-							}
-						}
-					}
+	const uint32_t &Nelems = m_parser.get_Nelems();
+	const std::vector<uint32_t> &NPSUE = m_parser.get_NPSUE();
+
+	// One neighbour per face, boundary markers are appended by solveElemSurrFace
+	m_elemToElem.assignRowSizes(NPSUE);
+	m_elemToElemFill = m_scratch.allocate<uint32_t>(Nelems);
+
+	// Face ifael of an element links its local nodes ifael and ifael + 1
+#pragma omp parallel for schedule(dynamic, 1024) default(none) shared(Nelems, NPSUE)
+	for (uint32_t ielem = 0; ielem < Nelems; ielem++) {
+		const uint32_t nnode = NPSUE[ielem];
+		uint32_t nsurr = 0;
+
+		for (uint32_t ifael = 0; ifael < nnode; ifael++) {
+			const uint32_t ipoi1 = connecNodeSurrElement(ifael, ielem);
+			const uint32_t ipoi2 = connecNodeSurrElement((ifael + 1) % nnode, ielem);
+
+			for (uint32_t istor = m_esup2[ipoi1]; istor < m_esup2[ipoi1 + 1]; istor++) {
+				const uint32_t jelem = m_esup1[istor];
+				if (jelem != ielem && hasEdge(jelem, ipoi1, ipoi2)) {
+					m_elemToElem(ielem, nsurr++) = jelem;
 				}
 			}
-			for (uint32_t nnofa = 0; nnofa < 2; nnofa++) {
-				m_lpoin[lhelp[nnofa]] = 0;
-			}
 		}
-		m_elemToElem.push_back(temp_surr_elem);
+		m_elemToElemFill[ielem] = nsurr;
 	}
 	std::cout << std::setw(40) << "Element to element connectivity : " << std::setw(6) << "Done\n";
 }
@@ -241,98 +287,44 @@ void Connectivity::solveElemSurrElem() {
 //---------------------------------------------------------------------
 
 void Connectivity::solveNodeSurrFace() {
+	EES2D_PROFILE_ZONE("solveNodeSurrFace");
 
-	for (uint32_t i = 0; i < m_lpoin_size; i++) {
-		m_lpoin[i] = 0;
-	}
+	// Faces are numbered by lowest node, then by order of appearance around that node
+	// An edge is two consecutive local nodes of an element, whatever its type, so triangles
+	// and quadrilaterals can be mixed in the same mesh
+	const uint32_t &Ngrids = m_parser.get_Ngrids();
+	const uint32_t maxDegree = maxNodeDegree();
+	uint32_t *edges = m_scratch.allocate<uint32_t>(size_t(maxDegree) * omp_get_max_threads());
 
+	m_inpoe1 = m_scratch.allocate<uint32_t>(m_psup2_size);
 	m_inpoe1[0] = 0;
-	uint32_t nedge = 0;
-	uint32_t ielem = 0;
-	uint32_t jpoin = 0;
-
-	std::vector<uint32_t> temp = {};
-	std::vector<uint32_t> doubles = {};
-	std::vector<uint32_t> temp2 = {};
-	uint32_t nodeToPush1;
-	uint32_t nodeToPush2;
-	if (m_parser.get_NPSUE()[0] == 4) {
-		uint32_t node1;
-		uint32_t node2;
-		uint32_t node3;
-		uint32_t node4;
-		for (uint32_t ielem = 0; ielem < m_parser.get_Nelems(); ielem++) {
-			temp = {};
-
-			node1 = connecNodeSurrElement(0, ielem);
-			node2 = connecNodeSurrElement(1, ielem);
-			node3 = connecNodeSurrElement(2, ielem);
-			node4 = connecNodeSurrElement(3, ielem);
-			temp.push_back(node1);
-			temp.push_back(node2);
-			temp.push_back(node3);
-			temp.push_back(node4);
-			for (uint32_t i = 0; i < 4; i++) {
-				temp2 = {};
-				nodeToPush1 = temp[i % 4];// 4%4 = 0 go back to node 0
-				nodeToPush2 = temp[(i + 1) % 4];
-				if (nodeToPush1 > nodeToPush2) {
-					std::swap(nodeToPush1, nodeToPush2);
-				}
-				temp2.push_back(nodeToPush1);
-				temp2.push_back(nodeToPush2);
-				m_faceToNode.push_back(temp2);
-			}
+
+	// Pass 1 : Count the faces of each lowest node
+#pragma omp parallel default(none) shared(Ngrids, maxDegree, edges)
+	{
+		uint32_t *local = edges + size_t(maxDegree) * omp_get_thread_num();
+#pragma omp for schedule(dynamic, 1024)
+		for (uint32_t ipoin = 0; ipoin < Ngrids; ipoin++) {
+			m_inpoe1[ipoin + 1] = collectNodeNeighbours(ipoin, local, true);
 		}
-		std::sort(m_faceToNode.begin(), m_faceToNode.end());
-		auto last = std::unique(m_faceToNode.begin(), m_faceToNode.end());
-		m_faceToNode.erase(last, m_faceToNode.end());
-
-	} else if (m_parser.get_NPSUE()[0] == 3) {
-		bool skip = false;
-
-		for (uint32_t ipoin = 0; ipoin < m_parser.get_Ngrids(); ipoin++) {
-
-			for (uint32_t iesup = m_esup2[ipoin]; iesup < m_esup2[ipoin + 1]; iesup++) {
-				ielem = m_esup1[iesup];
-
-				for (uint32_t inode = 0; inode < m_parser.get_NPSUE()[ielem]; inode++) {
-					jpoin = connecNodeSurrElement(inode, ielem);
-					if ((jpoin != ipoin) && (m_lpoin[jpoin] != ipoin || ipoin == 0)) {
-						if (ipoin < jpoin) {
-							if (ipoin == 0) {
-								skip = false;
-								for (auto &value : doubles) {
-									if (jpoin == value) {
-										skip = true;
-										break;
-									}
-								}
-								if (skip == true) {
-
-								} else if (skip == false) {
-									doubles.push_back(jpoin);
-									nedge += 1;
-									temp = {};
-									temp.push_back(ipoin);
-									temp.push_back(jpoin);
-									m_faceToNode.push_back(temp);
-									m_lpoin[jpoin] = ipoin;
-								}
-
-							} else {// Not sure in which order faces should be created
-								nedge += 1;
-								temp = {};
-								temp.push_back(ipoin);
-								temp.push_back(jpoin);
-								m_faceToNode.push_back(temp);
-								m_lpoin[jpoin] = ipoin;
-							}
-						}
-					}
-				}
+	}
+
+	for (uint32_t ipoin = 1; ipoin < m_psup2_size; ipoin++) {
+		m_inpoe1[ipoin] += m_inpoe1[ipoin - 1];
+	}
+
+	// Pass 2 : Store the faces
+	m_faceToNode.resize(m_inpoe1[Ngrids]);
+#pragma omp parallel default(none) shared(Ngrids, maxDegree, edges)
+	{
+		uint32_t *local = edges + size_t(maxDegree) * omp_get_thread_num();
+#pragma omp for schedule(dynamic, 1024)
+		for (uint32_t ipoin = 0; ipoin < Ngrids; ipoin++) {
+			const uint32_t nedge = collectNodeNeighbours(ipoin, local, true);
+			for (uint32_t iedge = 0; iedge < nedge; iedge++) {
+				m_faceToNode(m_inpoe1[ipoin] + iedge, 0) = ipoin;
+				m_faceToNode(m_inpoe1[ipoin] + iedge, 1) = local[iedge];
 			}
-			m_inpoe1[ipoin + 1] = nedge;
 		}
 	}
 	std::cout << std::setw(40) << "Face to node connectivity : " << std::setw(6) << " Done\n";
@@ -341,53 +333,30 @@ void Connectivity::solveNodeSurrFace() {
 //----------------------------------------------------------------------
 
 void Connectivity::solveFaceSurrElem() {
+	EES2D_PROFILE_ZONE("solveFaceSurrElem");
 
-	uint32_t ipoi1 = 0;
-	uint32_t ipoi2 = 0;
-	uint32_t ipmin = 0;
-	uint32_t ipmax = 0;
-
-	if (m_parser.get_NPSUE()[0] == 4) {
-		// FaceSurrElem is not used for a face based solver
-
-	} else if (m_parser.get_NPSUE()[0] == 3) {
-		std::vector<std::vector<uint32_t>> m_lpoed3 = {{0, 1},
-		                                               {1, 2},
-		                                               {2, 0}};
-
-		std::vector<std::vector<uint32_t>> m_lpoed4 = {{0, 1},
-		                                               {1, 2},
-		                                               {2, 3},
-		                                               {3, 0}};
-
-		std::vector<std::vector<uint32_t>> *m_lpoed;
-
-		m_elemToFace.reserve(m_parser.get_Nelems());
-
-		std::vector<uint32_t> temp = {};
+	const uint32_t &Nelems = m_parser.get_Nelems();
+	const std::vector<uint32_t> &NPSUE = m_parser.get_NPSUE();
 
-		for (uint32_t ielem = 0; ielem < m_parser.get_Nelems(); ielem++) {
-			temp = {};
-			for (uint32_t iedel = 0; iedel < m_parser.get_NPSUE()[ielem]; iedel++) {
+	// Face iedel of an element links its local nodes iedel and iedel + 1, for every element type
+	m_elemToFace.assignRowSizes(NPSUE);
 
-				if (m_parser.get_NPSUE()[ielem] == 3) {
-					m_lpoed = &m_lpoed3;
-				} else if (m_parser.get_NPSUE()[ielem] == 4) {
-					m_lpoed = &m_lpoed4;
-				}
+#pragma omp parallel for schedule(dynamic, 1024) default(none) shared(Nelems, NPSUE)
+	for (uint32_t ielem = 0; ielem < Nelems; ielem++) {
+		const uint32_t nnode = NPSUE[ielem];
 
-				ipoi1 = connecNodeSurrElement((*m_lpoed)[iedel][0], ielem);
-				ipoi2 = connecNodeSurrElement((*m_lpoed)[iedel][1], ielem);
-				ipmin = std::min(ipoi1, ipoi2);
-				ipmax = std::max(ipoi1, ipoi2);
+		for (uint32_t iedel = 0; iedel < nnode; iedel++) {
+			const uint32_t ipoi1 = connecNodeSurrElement(iedel, ielem);
+			const uint32_t ipoi2 = connecNodeSurrElement((iedel + 1) % nnode, ielem);
+			const uint32_t ipmin = std::min(ipoi1, ipoi2);
+			const uint32_t ipmax = std::max(ipoi1, ipoi2);
 
-				for (uint32_t iedge = m_inpoe1[ipmin]; iedge < m_inpoe1[ipmin + 1]; iedge++) {
-					if (m_faceToNode[iedge][1] == ipmax) {
-						temp.push_back(iedge);
-					}
+			for (uint32_t iedge = m_inpoe1[ipmin]; iedge < m_inpoe1[ipmin + 1]; iedge++) {
+				if (m_faceToNode(iedge, 1) == ipmax) {
+					m_elemToFace(ielem, iedel) = iedge;
+					break;
 				}
 			}
-			m_elemToFace.push_back(temp);
 		}
 	}
 	std::cout << std::setw(40) << "Element to Face connectivity : " << std::setw(6) << " Done\n";
@@ -396,42 +365,61 @@ void Connectivity::solveFaceSurrElem() {
 //-------------------------------------------------------------------------------------------------
 
 void Connectivity::solveElemSurrFace() {
-
-	m_faceToElem.reserve(m_faceToNode.size());
-
-
-	std::vector<uint32_t> temp;
-	temp.reserve(2);
-	const uint32_t &lastBCVectorLength = m_parser.get_boundaryConditions().back().size();
-
-
-	for (uint32_t nface = 0; nface < m_faceToNode.size(); nface++) {
-		temp = {};
-		const uint32_t &node1 = m_faceToNode[nface][0];
-		const uint32_t &node2 = m_faceToNode[nface][1];
-		for (uint32_t elemsIndexNode1 = m_esup2[node1]; elemsIndexNode1 < m_esup2[node1 + 1]; elemsIndexNode1++) {
+	EES2D_PROFILE_ZONE("solveElemSurrFace");
+
+	const uint32_t nfaces = m_faceToNode.size();
+	m_faceToElem.resize(nfaces);
+	uint8_t *nelems = m_scratch.allocate<uint8_t>(nfaces);
+
+	// Elements on both sides of each face : the elements shared by its two nodes
+#pragma omp parallel for schedule(dynamic, 1024) default(none) shared(nfaces, nelems)
+	for (uint32_t nface = 0; nface < nfaces; nface++) {
+		uint8_t count = 0;
+		const uint32_t &node1 = m_faceToNode(nface, 0);
+		const uint32_t &node2 = m_faceToNode(nface, 1);
+		for (uint32_t elemsIndexNode1 = m_esup2[node1]; elemsIndexNode1 < m_esup2[node1 + 1] && count < 2; elemsIndexNode1++) {
 			const uint32_t &ElemNode1 = m_esup1[elemsIndexNode1];
 			for (uint32_t elemsIndexNode2 = m_esup2[node2]; elemsIndexNode2 < m_esup2[node2 + 1]; elemsIndexNode2++) {
 				const uint32_t &ElemNode2 = m_esup1[elemsIndexNode2];
 				if (ElemNode1 == ElemNode2) {
-					temp.push_back(ElemNode1);
+					m_faceToElem(nface, count++) = ElemNode1;
 					break;
 				}
 			}
 		}
-		// Add Boundary element with the corresponding boundary ID
-		if (temp.size() == 1) {
-			for (uint32_t i = 0; i < lastBCVectorLength; i++) {
-				if (node1 == m_parser.get_boundaryConditions().back()[i]) {
-					if (node2 == m_parser.get_boundaryConditions()[i][1]) {
-						temp.push_back(m_parser.get_boundaryConditions()[i][2]);
-						m_elemToElem[temp[0]].push_back(m_parser.get_boundaryConditions()[i][2]);
-						break;
-					}
-				}
+		nelems[nface] = count;
+	}
+
+	// Index of the boundary edges of the mesh file by node pair
+	// The last vector of get_boundaryConditions() only lists first nodes, it is not an edge
+	const std::vector<std::vector<uint32_t>> &boundaryConditions = m_parser.get_boundaryConditions();
+	const uint32_t nBoundaryEdges = boundaryConditions.size() - 1;
+	std::unordered_map<uint64_t, uint32_t> boundaryEdges;
+	boundaryEdges.reserve(nBoundaryEdges);
+	for (uint32_t i = 0; i < nBoundaryEdges; i++) {
+		boundaryEdges.emplace(edgeKey(boundaryConditions[i][0], boundaryConditions[i][1]), i);// First marker wins on duplicates
+	}
+
+	// Add Boundary element with the corresponding boundary ID
+	// Kept serial : it appends to m_elemToElem in face order
+	m_faceToMarker.assign(nfaces, noMarker);
+
+	for (uint32_t nface = 0; nface < nfaces; nface++) {
+		if (nelems[nface] == 1) {
+			const uint32_t &node1 = m_faceToNode(nface, 0);
+			const uint32_t &node2 = m_faceToNode(nface, 1);
+			const uint32_t &elem = m_faceToElem(nface, 0);
+
+			auto edge = boundaryEdges.find(edgeKey(node1, node2));
+			if (edge == boundaryEdges.end()) {
+				std::cerr << "Error : boundary face (" << node1 << ", " << node2 << ") has no marker in the mesh file" << std::endl;
+				exit(EXIT_FAILURE);
 			}
+			const uint32_t &BCID = boundaryConditions[edge->second][2];
+			m_faceToElem(nface, 1) = BCID;
+			m_elemToElem(elem, m_elemToElemFill[elem]++) = BCID;
+			m_faceToMarker[nface] = m_parser.get_boundaryMarkers()[edge->second];
 		}
-		m_faceToElem.push_back(temp);
 	}
 
 	std::cout << std::setw(40) << "Face to Element connectivity : " << std::setw(6) << " Done\n";
@@ -22,18 +22,26 @@
  * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
  */
 #pragma once
-#include "io/Su2Parser.h"
+#include "io/AbstractParser.h"
+#include "utils/Arena.h"
+#include "utils/CsrArray.h"
 #include <iostream>
 
 typedef std::shared_ptr<uint32_t[]> sharedUintPtrArray;
-typedef std::vector<std::vector<uint32_t>> IntVector2D;
+typedef ees2d::utils::CsrArray<uint32_t> IntCsrArray;
+typedef ees2d::utils::StridedArray<uint32_t, 2> IntPairArray;
 
 namespace ees2d::mesh {
 
+	class MeshCache;
+
 	class Connectivity {
+		friend class MeshCache;// Saves and restores the tables without solving them
 
 public:
-		Connectivity(ees2d::io::Su2Parser &parser);
+		static constexpr uint32_t noMarker = uint32_t(-1);// Marker of interior faces
+
+		Connectivity(ees2d::io::AbstractParser &parser);
 
 		const uint32_t &connecNodeSurrElement(const uint32_t &pointPos, const uint32_t &elementID) const ;// Return nodeID given an Element ID and its local node ID (from 0 to 2 for a 3 node element)
 		void solve();                                                                              // Call all below methods
@@ -44,6 +52,9 @@ public:
 		void solveFaceSurrElem();                                                                  // Populate m_elemToFace vector
 		void solveElemSurrFace();                                                                  // Populate m_faceToElem vector
 		void solveElemIDtoBC();                                                                    // Populate m_ElemToBC unordred map
+		// Every solve method runs in parallel (OpenMP) and produces the same tables as a serial run
+
+		void reportMemory(ees2d::utils::MemoryReport &report) const;                               // Bytes held by each table
 
 
 		// getters for arrays and vectors
@@ -52,11 +63,12 @@ public:
 		inline const sharedUintPtrArray get_psup2() { return m_psup2; }
 		inline const std::vector<uint32_t> *get_psup1() { return &m_psup1; }
 		//inline const std::shared_ptr<std::unique_ptr<uint32_t[]>[]> get_elemToElem() {return m_elemToElem;}
-		inline const std::vector<std::vector<uint32_t>> *get_elemToElem() const { return &m_elemToElem; }
-		inline const std::vector<std::vector<uint32_t>> *get_FaceToNode() const { return &m_faceToNode; }
-		inline const std::vector<std::vector<uint32_t>> *get_ElemToFace() const { return &m_elemToFace; }
-		inline const std::vector<std::vector<uint32_t>> *get_FaceToElem() const { return &m_faceToElem; }
-		inline ees2d::io::Su2Parser& get_parser() const {return m_parser;}
+		inline const IntCsrArray *get_elemToElem() const { return &m_elemToElem; }
+		inline const IntPairArray *get_FaceToNode() const { return &m_faceToNode; }
+		inline const IntCsrArray *get_ElemToFace() const { return &m_elemToFace; }
+		inline const IntPairArray *get_FaceToElem() const { return &m_faceToElem; }
+		inline const std::vector<uint32_t> *get_FaceToMarker() const { return &m_faceToMarker; }
+		inline ees2d::io::AbstractParser& get_parser() const {return m_parser;}
 
 		//getters for values
 		inline const uint32_t &get_esup2_size() { return m_esup2_size; }
@@ -66,18 +78,24 @@ public:
 
 
 private:
-		ees2d::io::Su2Parser &m_parser;
+		uint32_t maxNodeDegree();                                                                  // Upper bound of the number of nodes connected to a node
+		uint32_t collectNodeNeighbours(const uint32_t &ipoin, uint32_t *neighbours, bool edgesOnly);// Distinct nodes sharing an element (or an edge with a higher ID) with ipoin
+		bool hasEdge(const uint32_t &elementID, const uint32_t &node1, const uint32_t &node2) const;
+
+		ees2d::io::AbstractParser &m_parser;
+		ees2d::utils::Arena m_scratch;                                                             // Temporary arrays used while solving, freed at the end of solve()
 
 		sharedUintPtrArray m_esup2 = nullptr;                                                         // Array containing Element position in m_esup1 (Linked list)
 		sharedUintPtrArray m_esup1 = nullptr;                                                         // Linked list containing ElementIDs surrouding a specific node, used with m_esup2
 		std::vector<uint32_t> m_psup1;                                                            // Linked list to find Node to Node connectivity (m_psup1 and m_psup2)
 		sharedUintPtrArray m_psup2 = nullptr;
-		uint32_t *m_lpoin = nullptr;                                                               // Temporary help array used to solve connecitivity
-		IntVector2D m_elemToElem;                                                                  // 2D Uint32 vector contains Element IDs surrounding a specific element. Usage : m_elemToElem[ELEMID][LocalElEMID]
-		IntVector2D m_faceToNode;                                                                  // 2D Uint32 vector contains NOde IDs surrounding a specific face. Usage : m_faceToNode[Face][LocalNODEID]
-		IntVector2D m_elemToFace;                                                                  // 2D Uint32 vector contains Face IDs surrounding a specific Element. Usage : m_elemToFace[ELEMID][LocalFACEID]
-		IntVector2D m_faceToElem;                                                                  // 2D Uint32 vector contains Elements IDs surrounding a specific face. Usage : m_faceToElem[FACE][localELEMID]
-		uint32_t *m_inpoe1 = nullptr;                                                              // Temporary help array used to solve connecitivity
+		IntCsrArray m_elemToElem;                                                                  // One row per element, contains Element IDs (or BC ID) surrounding a specific element. Usage : m_elemToElem(ELEMID, LocalElEMID)
+		IntPairArray m_faceToNode;                                                                 // Two Node IDs per face. Usage : m_faceToNode(Face, LocalNODEID)
+		IntCsrArray m_elemToFace;                                                                  // One row per element, contains Face IDs surrounding a specific Element. Usage : m_elemToFace(ELEMID, LocalFACEID)
+		IntPairArray m_faceToElem;                                                                 // Two Element IDs (or Element ID and BC ID) per face. Usage : m_faceToElem(FACE, localELEMID)
+		std::vector<uint32_t> m_faceToMarker;                                                      // Marker (position in parser marker tags) of each face, noMarker for interior faces
+		uint32_t *m_elemToElemFill = nullptr;                                                      // Entries of each m_elemToElem row already filled, in m_scratch
+		uint32_t *m_inpoe1 = nullptr;                                                              // Faces of each lowest node, in m_scratch (Usage : faces [m_inpoe1[node], m_inpoe1[node + 1]) )
 
 		//size is unknown for psup1, should be dynamically allocated
 
@@ -85,7 +103,6 @@ private:
 		uint32_t m_esup2_size{0};
 		uint32_t m_esup1_size{0};
 		uint32_t m_psup2_size{0};
-		uint32_t m_lpoin_size{0};
 		uint32_t m_esuel_size{0};
 	};
 
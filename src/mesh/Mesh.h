@@ -37,6 +37,10 @@ namespace ees2d::mesh {
 			N_faces = m_connectivity.get_FaceToElem()->size();
 			N_nodes = m_connectivity.get_parser().get_Ngrids();
 
+			// Fixed stride tables, indexed directly on the hot path
+			m_faceToElem = m_connectivity.get_FaceToElem()->row(0);
+			m_faceToNode = m_connectivity.get_FaceToNode()->row(0);
+
 		}
 
 
@@ -53,19 +57,27 @@ namespace ees2d::mesh {
 		}
 		//---------------------------------------------------
 		inline const uint32_t &ElemToElem(const uint32_t &ElemId, const uint32_t &LocalElemId) const {
-			return (*m_connectivity.get_elemToElem())[ElemId][LocalElemId];
+			return (*m_connectivity.get_elemToElem())(ElemId, LocalElemId);
 		}
 		//---------------------------------------------------
 		inline const uint32_t &FaceToNode(const uint32_t &FaceId, const uint32_t &LocalNodeId) const {
-			return (*m_connectivity.get_FaceToNode())[FaceId][LocalNodeId];
+			return m_faceToNode[2 * FaceId + LocalNodeId];
 		}
 		//---------------------------------------------------
 		inline const uint32_t &ElemToFace(const uint32_t &ElemId, const uint32_t &LocalFaceId) const {
-			return (*m_connectivity.get_ElemToFace())[ElemId][LocalFaceId];
+			return (*m_connectivity.get_ElemToFace())(ElemId, LocalFaceId);
 		}
 		//---------------------------------------------------
 		inline const uint32_t &FaceToElem(const uint32_t &FaceId, const uint32_t &LocalElemId) const {
-			return (*m_connectivity.get_FaceToElem())[FaceId][LocalElemId];
+			return m_faceToElem[2 * FaceId + LocalElemId];
+		}
+		//---------------------------------------------------
+		inline const uint32_t &FaceToMarker(const uint32_t &FaceId) const {// Connectivity::noMarker for interior faces
+			return (*m_connectivity.get_FaceToMarker())[FaceId];
+		}
+		//---------------------------------------------------
+		inline const std::string &MarkerTag(const uint32_t &MarkerId) const {
+			return m_connectivity.get_parser().get_markerTags()[MarkerId];
 		}
 		//---------------------------------------------------
 		inline const double &FaceSurface(const uint32_t &FaceId) const {
@@ -99,6 +111,8 @@ namespace ees2d::mesh {
 private:
 		ees2d::mesh::Connectivity &m_connectivity;
 		ees2d::mesh::MetricsData &m_metrics;
+		const uint32_t *m_faceToElem;// Two elements per face, see Connectivity::get_FaceToElem()
+		const uint32_t *m_faceToNode;// Two nodes per face, see Connectivity::get_FaceToNode()
 
 	};
 
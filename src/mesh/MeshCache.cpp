@@ -0,0 +1,382 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+#include "mesh/MeshCache.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using ees2d::io::AbstractParser;
+using ees2d::mesh::Connectivity;
+using ees2d::mesh::MeshCache;
+using ees2d::mesh::MetricsData;
+using ees2d::utils::MappedFile;
+using ees2d::utils::Vector2;
+
+
+namespace {
+	constexpr char cacheMagic[8] = {'E', 'E', 'S', '2', 'D', 'M', 'S', 'H'};
+
+	template<class T>
+	std::string_view bytesOf(const T *data, size_t count) {
+		return {reinterpret_cast<const char *>(data), count * sizeof(T)};
+	}
+
+	template<class T>
+	std::string_view bytesOf(const std::vector<T> &vec) {
+		return bytesOf(vec.data(), vec.size());
+	}
+
+	template<class T>
+	std::vector<T> vectorOf(std::string_view bytes) {
+		std::vector<T> vec(bytes.size() / sizeof(T));
+		std::memcpy(vec.data(), bytes.data(), vec.size() * sizeof(T));
+		return vec;
+	}
+
+	// Vector2 is not trivially copyable, it is stored as {x, y} pairs
+	std::vector<double> flatten(const std::vector<Vector2<double>> &vec) {
+		std::vector<double> flat(2 * vec.size());
+		for (size_t i = 0; i < vec.size(); i++) {
+			flat[2 * i] = vec[i].x;
+			flat[2 * i + 1] = vec[i].y;
+		}
+		return flat;
+	}
+
+	// Number of T in a section, or -1 if its size is not a whole number of T
+	template<class T>
+	size_t countOf(std::string_view bytes) {
+		return bytes.size() % sizeof(T) == 0 ? bytes.size() / sizeof(T) : size_t(-1);
+	}
+
+	template<class T>
+	T valueAt(std::string_view bytes, size_t i) {
+		T value;
+		std::memcpy(&value, bytes.data() + i * sizeof(T), sizeof(T));
+		return value;
+	}
+
+	std::vector<Vector2<double>> unflatten(std::string_view bytes) {
+		const size_t count = bytes.size() / (2 * sizeof(double));
+		std::vector<Vector2<double>> vec;
+		vec.reserve(count);
+		for (size_t i = 0; i < count; i++) {
+			vec.emplace_back(valueAt<double>(bytes, 2 * i), valueAt<double>(bytes, 2 * i + 1));
+		}
+		return vec;
+	}
+}// namespace
+
+
+MeshCache::MeshCache(const std::string &meshPath, const std::string &cachePath)
+    : m_meshPath(meshPath), m_cachePath(cachePath) {}
+
+//---------------------------------------------------------------
+
+bool MeshCache::open() {
+	m_sections.clear();
+	m_file.reset();
+
+	// The mesh file is identified by its size and modification time, it is not read
+	std::error_code error;
+	m_meshSize = std::filesystem::file_size(m_meshPath, error);
+	if (error) {
+		return false;
+	}
+	m_meshTime = std::filesystem::last_write_time(m_meshPath, error).time_since_epoch().count();
+	if (error) {
+		return false;
+	}
+
+	auto file = std::make_shared<MappedFile>(m_cachePath);
+	if (!file->isOpen() || file->size() < sizeof(Header)) {
+		return false;
+	}
+
+	Header header;
+	std::memcpy(&header, file->data(), sizeof(Header));
+	if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.version != version ||
+	    header.numSections != NumSections || header.meshTime != m_meshTime || header.meshSize != m_meshSize) {
+		std::cout << std::setw(40) << "Mesh cache : " << std::setw(6) << "Outdated\n";
+		return false;
+	}
+
+	// Walk the sections, each one is padded to 8 bytes
+	size_t offset = sizeof(Header);
+	for (uint32_t section = 0; section < NumSections; section++) {
+		uint64_t bytes;
+		if (offset + sizeof(bytes) > file->size()) {
+			return false;
+		}
+		std::memcpy(&bytes, file->data() + offset, sizeof(bytes));
+		offset += sizeof(bytes);
+		if (offset + bytes > file->size()) {
+			return false;
+		}
+		m_sections.emplace_back(file->data() + offset, bytes);
+		offset += (bytes + 7) / 8 * 8;
+	}
+
+	if (!validSections()) {
+		std::cout << std::setw(40) << "Mesh cache : " << std::setw(6) << "Outdated\n";
+		m_sections.clear();
+		return false;
+	}
+
+	m_file = std::move(file);
+	std::cout << std::setw(40) << "Mesh cache : " << std::setw(6) << m_cachePath << "\n";
+	return true;
+}
+
+//---------------------------------------------------------------
+
+bool MeshCache::validSections() const {
+	const size_t noCount = size_t(-1);
+	if (countOf<uint32_t>(m_sections[ParserSizes]) != 4) {
+		return false;
+	}
+	const size_t Ngrids = valueAt<uint32_t>(m_sections[ParserSizes], 1);
+	const size_t Nelems = valueAt<uint32_t>(m_sections[ParserSizes], 2);
+
+	// Element types of the arrays without a size of their own
+	for (Section section : {ElemIds, BoundaryFirstNodes, BoundaryMarkers}) {
+		if (countOf<uint32_t>(m_sections[section]) == noCount) {
+			return false;
+		}
+	}
+	if (countOf<uint32_t>(m_sections[BoundaryEdges]) % 3 != 0 || countOf<uint32_t>(m_sections[BoundaryEdges]) == noCount) {
+		return false;
+	}
+
+	// Parsed arrays
+	if (countOf<double>(m_sections[CoordsX]) != Ngrids || countOf<double>(m_sections[CoordsY]) != Ngrids ||
+	    countOf<uint32_t>(m_sections[NPSUE]) != Nelems || countOf<uint32_t>(m_sections[ElemIndex]) != Nelems + 1 ||
+	    countOf<uint32_t>(m_sections[CONNEC]) != valueAt<uint32_t>(m_sections[ElemIndex], Nelems)) {
+		return false;
+	}
+	size_t esup1Size = 0;
+	for (size_t ielem = 0; ielem < Nelems; ielem++) {
+		esup1Size += valueAt<uint32_t>(m_sections[NPSUE], ielem);
+	}
+
+	// Connectivity tables, with the sizes the Connectivity constructor allocates
+	if (countOf<uint32_t>(m_sections[Esup1]) != esup1Size || countOf<uint32_t>(m_sections[Esup2]) != Ngrids + 1 ||
+	    countOf<uint32_t>(m_sections[Psup2]) != Ngrids + 1 ||
+	    countOf<uint32_t>(m_sections[Psup1]) != valueAt<uint32_t>(m_sections[Psup2], Ngrids)) {
+		return false;
+	}
+	for (auto [index, values] : {std::pair(ElemToElemIndex, ElemToElem), std::pair(ElemToFaceIndex, ElemToFace)}) {
+		if (countOf<uint32_t>(m_sections[index]) != Nelems + 1 ||
+		    countOf<uint32_t>(m_sections[values]) != valueAt<uint32_t>(m_sections[index], Nelems)) {
+			return false;
+		}
+	}
+	const size_t Nfaces = countOf<uint32_t>(m_sections[FaceToNode]) / 2;
+	if (countOf<uint32_t>(m_sections[FaceToNode]) != 2 * Nfaces || countOf<uint32_t>(m_sections[FaceToElem]) != 2 * Nfaces ||
+	    countOf<uint32_t>(m_sections[FaceToMarker]) != Nfaces) {
+		return false;
+	}
+
+	// Metrics
+	return countOf<double>(m_sections[FacesMidPoint]) == 2 * Nfaces && countOf<double>(m_sections[FacesSurface]) == Nfaces &&
+	       countOf<double>(m_sections[FacesVector]) == 2 * Nfaces && countOf<double>(m_sections[CvolumesArea]) == Nelems &&
+	       countOf<double>(m_sections[CvolumesCentroid]) == 2 * Nelems;
+}
+
+//---------------------------------------------------------------
+
+void MeshCache::read(AbstractParser &parser) const {
+	const std::vector<uint32_t> sizes = vectorOf<uint32_t>(m_sections[ParserSizes]);
+	parser.m_Ndim = sizes[0];
+	parser.m_Ngrids = sizes[1];
+	parser.m_Nelems = sizes[2];
+	parser.m_Nboundaries = sizes[3];
+
+	parser.m_X = vectorOf<double>(m_sections[CoordsX]);
+	parser.m_Y = vectorOf<double>(m_sections[CoordsY]);
+
+	parser.m_ElemIds = vectorOf<uint32_t>(m_sections[ElemIds]);
+	parser.m_ElemIndex = vectorOf<uint32_t>(m_sections[ElemIndex]);
+	parser.m_NPSUE = vectorOf<uint32_t>(m_sections[NPSUE]);
+	parser.m_CONNEC = vectorOf<uint32_t>(m_sections[CONNEC]);
+
+	const std::vector<uint32_t> edges = vectorOf<uint32_t>(m_sections[BoundaryEdges]);
+	parser.m_boundaryConditions.clear();
+	parser.m_boundaryConditions.reserve(edges.size() / 3 + 1);
+	for (size_t i = 0; i + 2 < edges.size(); i += 3) {
+		parser.m_boundaryConditions.push_back({edges[i], edges[i + 1], edges[i + 2]});
+	}
+	parser.m_boundaryConditions.push_back(vectorOf<uint32_t>(m_sections[BoundaryFirstNodes]));
+
+	// Tags are stored one after the other, each one followed by '\0'
+	parser.m_markerTags.clear();
+	std::string_view tags = m_sections[MarkerTags];
+	while (!tags.empty()) {
+		const size_t end = tags.find('\0');
+		parser.m_markerTags.emplace_back(tags.substr(0, end));
+		tags.remove_prefix(std::min(end + 1, tags.size()));
+	}
+	parser.m_boundaryMarkers = vectorOf<uint32_t>(m_sections[BoundaryMarkers]);
+
+	std::cout << std::setw(40) << "Number of nodes : " << std::setw(6) << parser.m_Ngrids << "\n";
+	std::cout << std::setw(40) << "Number of elements : " << std::setw(6) << parser.m_Nelems << "\n";
+}
+
+//---------------------------------------------------------------
+
+bool MeshCache::read(Connectivity &connectivity) const {
+	// The arrays allocated by the constructor must have exactly the size of their section
+	if (m_sections[Esup1].size() != connectivity.m_esup1_size * sizeof(uint32_t) ||
+	    m_sections[Esup2].size() != connectivity.m_esup2_size * sizeof(uint32_t) ||
+	    m_sections[Psup2].size() != connectivity.m_psup2_size * sizeof(uint32_t) ||
+	    countOf<uint32_t>(m_sections[ElemToElemIndex]) != size_t(connectivity.m_esuel_size) + 1) {
+		std::cout << std::setw(40) << "Connectivity tables (cache) : " << std::setw(6) << "Outdated\n";
+		return false;
+	}
+
+	// Sections start on 8 bytes boundaries of the mapping, they are used in place
+	auto uints = [this](Section section) { return reinterpret_cast<const uint32_t *>(m_sections[section].data()); };
+
+	// The esup and psup2 arrays keep the mapping alive. They are only read once solved, the mapping is read-only
+	auto shared = [this, &uints](Section section) { return sharedUintPtrArray(m_file, const_cast<uint32_t *>(uints(section))); };
+	connectivity.m_esup1 = shared(Esup1);
+	connectivity.m_esup2 = shared(Esup2);
+	connectivity.m_psup2 = shared(Psup2);
+	connectivity.m_psup1 = vectorOf<uint32_t>(m_sections[Psup1]);
+	const size_t Nfaces = countOf<uint32_t>(m_sections[FaceToNode]) / 2;
+	connectivity.m_elemToElem.view(uints(ElemToElemIndex), connectivity.m_esuel_size, uints(ElemToElem));
+	connectivity.m_elemToFace.view(uints(ElemToFaceIndex), connectivity.m_esuel_size, uints(ElemToFace));
+	connectivity.m_faceToNode.view(uints(FaceToNode), Nfaces);
+	connectivity.m_faceToElem.view(uints(FaceToElem), Nfaces);
+	connectivity.m_faceToMarker = vectorOf<uint32_t>(m_sections[FaceToMarker]);
+
+	std::cout << std::setw(40) << "Connectivity tables (cache) : " << std::setw(6) << "Done\n";
+	return true;
+}
+
+//---------------------------------------------------------------
+
+void MeshCache::read(MetricsData &metrics) const {
+	metrics.facesMidPoint = unflatten(m_sections[FacesMidPoint]);
+	metrics.facesSurface = vectorOf<double>(m_sections[FacesSurface]);
+	metrics.facesVector = unflatten(m_sections[FacesVector]);
+	metrics.CvolumesArea = vectorOf<double>(m_sections[CvolumesArea]);
+	metrics.CvolumesCentroid = unflatten(m_sections[CvolumesCentroid]);
+
+	std::cout << std::setw(40) << "Geometrical quantities (cache) : " << std::setw(6) << "Done\n";
+}
+
+//---------------------------------------------------------------
+
+bool MeshCache::write(const AbstractParser &parser, const Connectivity &connectivity, const MetricsData &metrics) const {
+
+	// Flatten the nested containers
+	const std::vector<uint32_t> sizes = {parser.m_Ndim, parser.m_Ngrids, parser.m_Nelems, parser.m_Nboundaries};
+
+	// The last vector of m_boundaryConditions only lists the first node of each edge
+	std::vector<uint32_t> edges;
+	const size_t nEdges = parser.m_boundaryConditions.empty() ? 0 : parser.m_boundaryConditions.size() - 1;
+	edges.reserve(3 * nEdges);
+	for (size_t i = 0; i < nEdges; i++) {
+		edges.insert(edges.end(), parser.m_boundaryConditions[i].begin(), parser.m_boundaryConditions[i].begin() + 3);
+	}
+	const std::vector<uint32_t> firstNodes = parser.m_boundaryConditions.empty() ? std::vector<uint32_t>() : parser.m_boundaryConditions.back();
+
+	std::string tags;
+	for (auto &tag : parser.m_markerTags) {
+		tags += tag;
+		tags += '\0';
+	}
+
+	const std::vector<double> midPoints = flatten(metrics.facesMidPoint);
+	const std::vector<double> normals = flatten(metrics.facesVector);
+	const std::vector<double> centroids = flatten(metrics.CvolumesCentroid);
+
+	std::vector<std::string_view> sections(NumSections);
+	sections[ParserSizes] = bytesOf(sizes);
+	sections[CoordsX] = bytesOf(parser.m_X);
+	sections[CoordsY] = bytesOf(parser.m_Y);
+	sections[ElemIds] = bytesOf(parser.m_ElemIds);
+	sections[ElemIndex] = bytesOf(parser.m_ElemIndex);
+	sections[NPSUE] = bytesOf(parser.m_NPSUE);
+	sections[CONNEC] = bytesOf(parser.m_CONNEC);
+	sections[BoundaryEdges] = bytesOf(edges);
+	sections[BoundaryFirstNodes] = bytesOf(firstNodes);
+	sections[MarkerTags] = tags;
+	sections[BoundaryMarkers] = bytesOf(parser.m_boundaryMarkers);
+	sections[Esup1] = bytesOf(connectivity.m_esup1.get(), connectivity.m_esup1_size);
+	sections[Esup2] = bytesOf(connectivity.m_esup2.get(), connectivity.m_esup2_size);
+	sections[Psup1] = bytesOf(connectivity.m_psup1);
+	sections[Psup2] = bytesOf(connectivity.m_psup2.get(), connectivity.m_psup2_size);
+	sections[ElemToElemIndex] = bytesOf(connectivity.m_elemToElem.index(), connectivity.m_elemToElem.indexSize());
+	sections[ElemToElem] = bytesOf(connectivity.m_elemToElem.data(), connectivity.m_elemToElem.dataSize());
+	sections[FaceToNode] = bytesOf(connectivity.m_faceToNode.data(), connectivity.m_faceToNode.dataSize());
+	sections[ElemToFaceIndex] = bytesOf(connectivity.m_elemToFace.index(), connectivity.m_elemToFace.indexSize());
+	sections[ElemToFace] = bytesOf(connectivity.m_elemToFace.data(), connectivity.m_elemToFace.dataSize());
+	sections[FaceToElem] = bytesOf(connectivity.m_faceToElem.data(), connectivity.m_faceToElem.dataSize());
+	sections[FaceToMarker] = bytesOf(connectivity.m_faceToMarker);
+	sections[FacesMidPoint] = bytesOf(midPoints);
+	sections[FacesSurface] = bytesOf(metrics.facesSurface);
+	sections[FacesVector] = bytesOf(normals);
+	sections[CvolumesArea] = bytesOf(metrics.CvolumesArea);
+	sections[CvolumesCentroid] = bytesOf(centroids);
+
+	// Write next to the final file and rename, an interrupted run never leaves a truncated cache
+	const std::string tempPath = m_cachePath + ".tmp";
+	std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+	if (!stream.is_open()) {
+		std::cerr << "Unable to write mesh cache file : " << m_cachePath << std::endl;
+		return false;
+	}
+
+	Header header;
+	std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+	header.version = version;
+	header.numSections = NumSections;
+	header.meshTime = m_meshTime;
+	header.meshSize = m_meshSize;
+	stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+	const char padding[8] = {};
+	for (auto &section : sections) {
+		const uint64_t bytes = section.size();
+		stream.write(reinterpret_cast<const char *>(&bytes), sizeof(bytes));
+		stream.write(section.data(), bytes);
+		stream.write(padding, (8 - bytes % 8) % 8);
+	}
+	stream.close();
+
+	if (!stream || std::rename(tempPath.c_str(), m_cachePath.c_str()) != 0) {
+		std::cerr << "Unable to write mesh cache file : " << m_cachePath << std::endl;
+		std::remove(tempPath.c_str());
+		return false;
+	}
+
+	std::cout << std::setw(40) << "Mesh cache written : " << std::setw(6) << m_cachePath << "\n";
+	return true;
+}
@@ -0,0 +1,125 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#pragma once
+
+#include "io/AbstractParser.h"
+#include "mesh/Connectivity.h"
+#include "mesh/Metrics.h"
+#include "utils/MappedFile.h"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace ees2d::mesh {
+
+	class MeshCache {
+		// Binary image of a preprocessed mesh : parsed data, connectivity tables and metrics.
+		// It records the size and modification time of the mesh file it was built from and is ignored
+		// as soon as that file changes, or when a section doesn't have the size the mesh sizes imply.
+		// The cache file is mapped in memory and the connectivity tables are read-only views into the mapping :
+		// esup1, esup2 and psup2 share it (the mapping stays alive with them), the CSR tables (elemToElem,
+		// elemToFace, faceToNode, faceToElem) need the MeshCache to outlive the Connectivity.
+		// The arrays owned by std::vector members are still copied out of the mapping, once each : psup1,
+		// faceToMarker, the parsed arrays (coordinates, CONNEC, ElemIndex, NPSUE, boundary edges rebuilt as
+		// one vector per edge) and all the metrics. Opening the cache skips the parsing and the preprocessing,
+		// not these copies.
+		// Native endianness, a cache is not meant to be moved to another machine type.
+		// Usage :
+		/*      MeshCache cache(meshPath);
+                if (cache.open()) { cache.read(parser); ... cache.read(connectivity); ... cache.read(metrics); }
+                else { parse, solve, compute ... then cache.write(parser, connectivity, metrics); }
+        */
+
+public:
+		MeshCache(const std::string &meshPath, const std::string &cachePath);
+		explicit MeshCache(const std::string &meshPath) : MeshCache(meshPath, meshPath + ".cache") {}
+
+		bool open();// True if the cache file exists, was built from the current mesh file and is complete
+
+		// Only valid after open() returned true. The parser must be read before the Connectivity is constructed
+		void read(ees2d::io::AbstractParser &) const;
+		bool read(Connectivity &) const;// False if the tables don't match the sizes of the connectivity
+		void read(MetricsData &) const;
+
+		// Write the cache of the mesh file stated by open(), returns false if the file can't be written
+		bool write(const ees2d::io::AbstractParser &, const Connectivity &, const MetricsData &) const;
+
+		inline const std::string &path() const { return m_cachePath; }
+
+private:
+		// Sections are stored in this order, each one as its size in bytes followed by its content
+		enum Section : uint32_t {
+			ParserSizes,
+			CoordsX,
+			CoordsY,
+			ElemIds,
+			ElemIndex,
+			NPSUE,
+			CONNEC,
+			BoundaryEdges,
+			BoundaryFirstNodes,
+			MarkerTags,
+			BoundaryMarkers,
+			Esup1,
+			Esup2,
+			Psup1,
+			Psup2,
+			ElemToElemIndex,
+			ElemToElem,
+			FaceToNode,
+			ElemToFaceIndex,
+			ElemToFace,
+			FaceToElem,
+			FaceToMarker,
+			FacesMidPoint,
+			FacesSurface,
+			FacesVector,
+			CvolumesArea,
+			CvolumesCentroid,
+			NumSections
+		};
+
+		struct Header {
+			char magic[8];
+			uint32_t version;
+			uint32_t numSections;
+			int64_t meshTime;// Modification time of the mesh file, in file clock ticks
+			uint64_t meshSize;
+		};
+
+		static constexpr uint32_t version = 3;
+
+		bool validSections() const;// Every section has the size implied by the mesh sizes
+
+		std::string m_meshPath;
+		std::string m_cachePath;
+		int64_t m_meshTime = 0;
+		uint64_t m_meshSize = 0;
+		std::shared_ptr<ees2d::utils::MappedFile> m_file;// Shared with the esup and psup2 tables read from it
+		std::vector<std::string_view> m_sections;// Content of each section inside m_file
+	};
+
+}// namespace ees2d::mesh
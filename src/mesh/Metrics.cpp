@@ -21,6 +21,7 @@
 
 
 #include "mesh/Metrics.h"
+#include "utils/Profiler.h"
 
 #include <cmath>
 #include <iomanip>
@@ -33,6 +34,7 @@ using ees2d::utils::Vector2;
 //-----------------------------------------------------
 
 void MetricsData::compute(const Connectivity &ConnectivityObject) {
+	EES2D_PROFILE_ZONE("metrics");
   std::cout << " -------------- Computing Geometrical Quantities!"
                " --------------"
             << std::endl;
@@ -66,8 +68,8 @@ void MetricsData::computeCvolumesMetrics(const Connectivity &ConnectivityObject)
 		for (uint32_t ilocalNode = 0; ilocalNode < ConnectivityObject.get_parser().get_NPSUE()[ielem]; ilocalNode++) {
 
 
-			auto &[x, y] = ConnectivityObject.get_parser().get_coords()[ConnectivityObject.connecNodeSurrElement(ilocalNode, ielem)];
-			elem_nodes_temp.emplace_back(x, y);
+			const uint32_t &node = ConnectivityObject.connecNodeSurrElement(ilocalNode, ielem);
+			elem_nodes_temp.emplace_back(ConnectivityObject.get_parser().get_x()[node], ConnectivityObject.get_parser().get_y()[node]);
 		}
 
 		// If triangle
@@ -126,13 +128,15 @@ void MetricsData::computeFaceMetrics(const Connectivity &ConnectivityObject) {
 
 	for (uint32_t iface=0;iface<nfaces;iface++){
 
-		elem1 = (*ConnectivityObject.get_FaceToElem())[iface][0];
-		elem2 = (*ConnectivityObject.get_FaceToElem())[iface][1];
-		Node1ID = (*ConnectivityObject.get_FaceToNode())[iface][0];
-    Node2ID = (*ConnectivityObject.get_FaceToNode())[iface][1];
+		elem1 = (*ConnectivityObject.get_FaceToElem())(iface, 0);
+		elem2 = (*ConnectivityObject.get_FaceToElem())(iface, 1);
+		Node1ID = (*ConnectivityObject.get_FaceToNode())(iface, 0);
+    Node2ID = (*ConnectivityObject.get_FaceToNode())(iface, 1);
 
-		auto [x1,y1] = ConnectivityObject.get_parser().get_coords()[Node1ID];
-    auto [x2,y2] = ConnectivityObject.get_parser().get_coords()[Node2ID];
+		const double x1 = ConnectivityObject.get_parser().get_x()[Node1ID];
+		const double y1 = ConnectivityObject.get_parser().get_y()[Node1ID];
+		const double x2 = ConnectivityObject.get_parser().get_x()[Node2ID];
+		const double y2 = ConnectivityObject.get_parser().get_y()[Node2ID];
     length = std::sqrt(std::pow(x2-x1,2.0)+std::pow(y2-y1,2.0));
 		facesSurface.push_back(length);
 		facesMidPoint.emplace_back(Vector2<double>((x2+x1)/2,(y2+y1)/2));
@@ -157,3 +161,13 @@ void MetricsData::computeFaceMetrics(const Connectivity &ConnectivityObject) {
   std::cout << std::setw(40) << "Faces orientation : " << std::setw(6) << "Done\n";
 
 }
+
+//-----------------------------------------------------
+
+void MetricsData::reportMemory(ees2d::utils::MemoryReport &report) const {
+	report.addArray("metrics", "facesMidPoint", facesMidPoint);
+	report.addArray("metrics", "facesSurface", facesSurface);
+	report.addArray("metrics", "facesVector", facesVector);
+	report.addArray("metrics", "CvolumesArea", CvolumesArea);
+	report.addArray("metrics", "CvolumesCentroid", CvolumesCentroid);
+}
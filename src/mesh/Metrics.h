@@ -34,6 +34,7 @@ namespace ees2d::mesh
     void compute(const ees2d::mesh::Connectivity&);           // Calls below methods
     void computeFaceMetrics(const ees2d::mesh::Connectivity&);
     void computeCvolumesMetrics(const ees2d::mesh::Connectivity&);
+    void reportMemory(ees2d::utils::MemoryReport &report) const;  // Bytes held by each array
 
 
 		std::vector<ees2d::utils::Vector2<double>> facesMidPoint;                  // Holds mid points of faces. Usage ->
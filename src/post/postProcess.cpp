@@ -34,10 +34,9 @@ void PostProcess::solveCoefficients() {
 	 * Compute and write Cp files specified pressure file path
 	 */
 
-  // Initialize variables for summation
-	double CL =0;
-	double CD =0;
-  double u_sqrd = m_sim.uInf * m_sim.uInf + m_sim.vInf * m_sim.vInf;
+	// Same wall faces and outward normals as the coefficients of the convergence history
+	const ForceCoefficients coefficients(m_mesh);
+	const std::vector<uint32_t> &wallFaces = coefficients.wallFaces();
 
 	// Initialize file
 	std::ofstream fileStream(m_sim.pressurePath);
@@ -48,57 +47,25 @@ void PostProcess::solveCoefficients() {
   fileStream << "AOA : " << m_sim.aoa << "\n";
 
 	// Writing CP
-	for (uint32_t iface = 0; iface < m_mesh.N_faces; iface++) {
-		uint32_t Elem1ID = m_mesh.FaceToElem(iface, 0);
-		uint32_t Elem2ID = m_mesh.FaceToElem(iface, 1);
-		if (Elem2ID == uint32_t(-1)) {
+	for (size_t k = 0; k < wallFaces.size(); k++) {
+		double Cp = coefficients.pressureCoefficient(m_sim, k);
 
-			double pinf = 1.0;
-			double p = m_sim.p[Elem1ID];
+		// COmpressibility correction (between M 0 and 0.7)
+//		double Mach = m_sim.Mach[m_mesh.FaceToElem(wallFaces[k], 0)];
+//		if (Mach < 0.7) {
+//			Cp = Cp / sqrt(1 - Mach * Mach);
+//		}
 
-			double Mach = m_sim.Mach[Elem1ID];
+		Cps.push_back(Cp);
 
-			double Cp = (p - pinf) / (0.5 * 1 * u_sqrd);
-
-
-			// COmpressibility correction (between M 0 and 0.7)
-//			if (Mach < 0.7) {
-//				Cp = Cp / sqrt(1 - Mach * Mach);
-//			}
-
-			Cps.push_back(Cp);
-
-			// Computations for lift and drag forces
-			outwardNormal(Elem1ID, iface);
-
-      CL += Cp*m_mesh.FaceSurface(iface)*(m_mesh.FaceVector(iface).y);
-			CD += Cp*m_mesh.FaceSurface(iface)*std::abs(m_mesh.FaceVector(iface).x);
-
-			fileStream << m_mesh.FaceMidPoint(iface).x
-			           << std::setw(18)
-			           << Cp
-			           << "\n";
-		}
+		fileStream << m_mesh.FaceMidPoint(wallFaces[k]).x
+		           << std::setw(18)
+		           << Cp
+		           << "\n";
 	}
 
-	std::cout << "Cl " << CL << " | Cd : " << std::abs(CD) << std::endl;
+	// Final coefficients, for the drivers checking them
+	coefficients.compute(m_sim);
+	std::cout << "Cl " << m_sim.CL << " | Cd : " << m_sim.CD << std::endl;
 	fileStream.close();
 }
-
-
-
-// -------------------------------------------
-void PostProcess::outwardNormal(const uint32_t &Elem1ID, const uint32_t &iface) {
-	/*
-	 * Orient the normal outward of the airfoil surface
-	 */
-	std::vector<double> midFaceToElem1{m_mesh.CvolumeCentroid(Elem1ID).x - m_mesh.FaceMidPoint(iface).x,
-	                                   m_mesh.CvolumeCentroid(Elem1ID).y - m_mesh.FaceMidPoint(iface).y};
-	double midFaceToElemNorm = std::sqrt(midFaceToElem1[0] * midFaceToElem1[0] + midFaceToElem1[1] * midFaceToElem1[1]);
-	double DotProduct = midFaceToElem1[0] * m_mesh.FaceVector(iface).x + midFaceToElem1[1] * m_mesh.FaceVector(iface).y;
-	double angle = std::acos(DotProduct / (midFaceToElemNorm * 1)) * (180 / M_PI);
-	if (angle <  80) {
-		m_mesh.FaceVector(iface).x *= -1;
-		m_mesh.FaceVector(iface).y *= -1;
-	}
-}
@@ -29,7 +29,6 @@ namespace ees2d::post {
 public:
 		PostProcess(ees2d::mesh::Mesh&, ees2d::solver::Simulation&);
 		void solveCoefficients();
-		void outwardNormal(const uint32_t &Elem1ID, const uint32_t &iface);
 
 		std::vector<double> Cps;
 
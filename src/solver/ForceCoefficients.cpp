@@ -0,0 +1,64 @@
+/*
+* This file is part of EES2D.
+*
+*   EES2D is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   EES2D is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+*
+* ---------------------------------------------------------------------
+*
+* Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+*/
+
+#include "solver/ForceCoefficients.h"
+#include <cmath>
+
+using ees2d::solver::ForceCoefficients;
+
+
+ForceCoefficients::ForceCoefficients(ees2d::mesh::Mesh &mesh) : m_mesh(mesh) {
+
+	for (uint32_t iface = 0; iface < m_mesh.N_faces; iface++) {
+		if (m_mesh.FaceToElem(iface, 1) != uint32_t(-1)) {
+			continue;
+		}
+		const uint32_t Elem1ID = m_mesh.FaceToElem(iface, 0);
+
+		// The face vector points inside the domain when it is within 80 degrees of the face to element direction
+		ees2d::utils::Vector2<double> normal = m_mesh.FaceVector(iface);
+		const double midFaceToElemX = m_mesh.CvolumeCentroid(Elem1ID).x - m_mesh.FaceMidPoint(iface).x;
+		const double midFaceToElemY = m_mesh.CvolumeCentroid(Elem1ID).y - m_mesh.FaceMidPoint(iface).y;
+		const double midFaceToElemNorm = std::sqrt(midFaceToElemX * midFaceToElemX + midFaceToElemY * midFaceToElemY);
+		const double DotProduct = midFaceToElemX * normal.x + midFaceToElemY * normal.y;
+		const double angle = std::acos(DotProduct / (midFaceToElemNorm * 1)) * (180 / M_PI);
+		if (angle < 80) {
+			normal.x *= -1;
+			normal.y *= -1;
+		}
+
+		m_wallFaces.push_back(iface);
+		m_normals.push_back(normal);
+	}
+}
+
+//---------------------------------------------------------------
+void ForceCoefficients::compute(Simulation &sim) const {
+	double CL = 0;
+	double CD = 0;
+	for (size_t k = 0; k < m_wallFaces.size(); k++) {
+		const double Cp = pressureCoefficient(sim, k);
+		CL += Cp * m_mesh.FaceSurface(m_wallFaces[k]) * m_normals[k].y;
+		CD += Cp * m_mesh.FaceSurface(m_wallFaces[k]) * std::abs(m_normals[k].x);
+	}
+	sim.CL = CL;
+	sim.CD = std::abs(CD);
+}
@@ -0,0 +1,55 @@
+/*
+* This file is part of EES2D.
+*
+*   EES2D is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   EES2D is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+*
+* ---------------------------------------------------------------------
+*
+* Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+*/
+
+#pragma once
+#include "mesh/Mesh.h"
+#include "solver/Simulation.h"
+#include "utils/Vector2.h"
+#include <cstdint>
+#include <vector>
+
+namespace ees2d::solver {
+
+	class ForceCoefficients {
+		// Lift and drag coefficients from the pressure on the wall faces (BC ID uint32_t(-1)).
+		// The normal of each wall face is oriented outward of the airfoil once, at construction,
+		// so compute() is a single loop over the wall faces that can run between iterations
+public:
+		explicit ForceCoefficients(ees2d::mesh::Mesh &mesh);
+
+		// Pressure coefficient of the element of wall face k (k-th face of wallFaces())
+		inline double pressureCoefficient(const Simulation &sim, size_t k) const {
+			const double u_sqrd = sim.uInf * sim.uInf + sim.vInf * sim.vInf;
+			const double pinf = 1.0;
+			return (sim.p[m_mesh.FaceToElem(m_wallFaces[k], 0)] - pinf) / (0.5 * 1 * u_sqrd);
+		}
+
+		void compute(Simulation &sim) const;// Sets sim.CL and sim.CD
+
+		inline const std::vector<uint32_t> &wallFaces() const { return m_wallFaces; }
+
+private:
+		ees2d::mesh::Mesh &m_mesh;
+		std::vector<uint32_t> m_wallFaces;                      // Faces on the wall, in face order
+		std::vector<ees2d::utils::Vector2<double>> m_normals;   // Outward normal of each wall face
+	};
+
+}// namespace ees2d::solver
@@ -0,0 +1,139 @@
+/*
+* This file is part of EES2D.
+*
+*   EES2D is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   EES2D is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+*
+* ---------------------------------------------------------------------
+*
+* Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+*/
+
+#include "solver/Scheduler.h"
+#include <algorithm>
+#include <iomanip>
+#include <unistd.h>
+
+using ees2d::solver::RegionStats;
+using ees2d::solver::TileScheduler;
+
+
+RegionStats::RegionStats(const std::string &tag, uint32_t numThreads)
+    : m_tag(tag), m_threadTimes(std::max(numThreads, 1u)) {}
+
+//---------------------------------------------------------------
+void RegionStats::endIteration() {
+	double minBusy = m_threadTimes[0].iterationBusy;
+	double maxBusy = 0;
+	double sumBusy = 0;
+	for (auto &times : m_threadTimes) {
+		minBusy = std::min(minBusy, times.iterationBusy);
+		maxBusy = std::max(maxBusy, times.iterationBusy);
+		sumBusy += times.iterationBusy;
+		times.iterationBusy = 0;
+	}
+	m_minBusy += minBusy;
+	m_maxBusy += maxBusy;
+	m_meanBusy += sumBusy / m_threadTimes.size();
+	m_iterations += 1;
+}
+
+//---------------------------------------------------------------
+void RegionStats::reset() {
+	for (auto &times : m_threadTimes) {
+		times = ThreadTimes();
+	}
+	m_iterations = 0;
+	m_maxBusy = 0;
+	m_meanBusy = 0;
+	m_minBusy = 0;
+}
+
+//---------------------------------------------------------------
+double RegionStats::busy() const {
+	double busy = 0;
+	for (auto &times : m_threadTimes) {
+		busy += times.busy;
+	}
+	return busy;
+}
+
+//---------------------------------------------------------------
+double RegionStats::barrierWait() const {
+	double wait = 0;
+	for (auto &times : m_threadTimes) {
+		wait += std::max(0.0, times.region - times.busy);
+	}
+	return wait;
+}
+
+//---------------------------------------------------------------
+void RegionStats::report(std::ostream &os) const {
+	os << std::setw(10) << "thread" << std::setw(15) << "busy (ms)" << std::setw(15) << "idle (ms)" << std::setw(12) << "busy (%)"
+	   << "\n";
+
+	for (uint32_t thread = 0; thread < m_threadTimes.size(); thread++) {
+		const ThreadTimes &times = m_threadTimes[thread];
+		const double idle = std::max(0.0, times.region - times.busy);
+		const double ratio = times.region > 0 ? 100 * times.busy / times.region : 0;
+		os << std::setw(10) << thread
+		   << std::setw(15) << times.busy * 1e3
+		   << std::setw(15) << idle * 1e3
+		   << std::setw(12) << ratio << "\n";
+	}
+
+	if (m_iterations > 0 && m_maxBusy > 0) {
+		const double perIteration = 1e3 / m_iterations;
+		os << std::setw(10) << "iteration" << "   busy min " << m_minBusy * perIteration << " / mean " << m_meanBusy * perIteration
+		   << " / max " << m_maxBusy * perIteration << " ms, " << 100 * imbalance() / m_maxBusy << " % lost to imbalance, barrier wait "
+		   << barrierWait() * perIteration / m_threadTimes.size() << " ms per thread (" << m_iterations << " iterations)\n";
+	}
+}
+
+//---------------------------------------------------------------
+TileScheduler::TileScheduler(const std::string &tag, uint32_t numThreads, size_t numItems, size_t bytesPerItem, uint32_t tileSize)
+    : m_numThreads(std::max(numThreads, 1u)), m_stats(tag, m_numThreads) {
+
+	if (tileSize == 0) {
+		tileSize = cacheTileSize(bytesPerItem);
+
+		// Keep at least 8 tiles per thread so idle threads have something left to pick up
+		const size_t balancedTile = (numItems + 8 * m_numThreads - 1) / (8 * m_numThreads);
+		tileSize = std::max<uint32_t>(64, std::min<size_t>(tileSize, balancedTile));
+	}
+	m_tileSize = tileSize;
+
+	m_tiles.reserve(numItems / m_tileSize + 2);
+	for (size_t begin = 0; begin < numItems; begin += m_tileSize) {
+		m_tiles.push_back(begin);
+	}
+	m_tiles.push_back(numItems);
+}
+
+//---------------------------------------------------------------
+uint32_t TileScheduler::cacheTileSize(size_t bytesPerItem) {
+	long l2Size = 0;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+	l2Size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+	if (l2Size <= 0) {
+		l2Size = 256 * 1024;// Conservative default when the OS does not report it
+	}
+	return std::max<size_t>(64, (l2Size / 2) / std::max<size_t>(bytesPerItem, 1));
+}
+
+//---------------------------------------------------------------
+void TileScheduler::report(std::ostream &os) const {
+	os << "[ " << m_stats.tag() << " ] " << numTiles() << " tiles of " << m_tileSize << " items\n";
+	m_stats.report(os);
+}
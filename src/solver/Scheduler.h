@@ -0,0 +1,126 @@
+/*
+* This file is part of EES2D.
+*
+*   EES2D is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   EES2D is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+*
+* ---------------------------------------------------------------------
+*
+* Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+*/
+
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <omp.h>
+#include <string>
+#include <vector>
+
+namespace ees2d::solver {
+
+	class RegionStats {
+		// Per-thread time of one parallel region : busy in the kernels, and the rest of the region spent
+		// waiting for the other threads at the closing barrier. endIteration() keeps the spread of the
+		// busy times between threads of every iteration, the time lost to load imbalance
+public:
+		RegionStats(const std::string &tag, uint32_t numThreads);
+
+		inline void addBusy(uint32_t thread, double seconds) {
+			m_threadTimes[thread].busy += seconds;
+			m_threadTimes[thread].iterationBusy += seconds;
+		}
+		inline void addRegion(uint32_t thread, double seconds) { m_threadTimes[thread].region += seconds; }
+
+		void endIteration();// Called by one thread, once every thread has left the region
+		void reset();
+		void report(std::ostream &) const;// Per-thread busy/idle time and per iteration spread since last reset
+
+		inline const std::string &tag() const { return m_tag; }
+		inline uint32_t iterations() const { return m_iterations; }
+		double busy() const;// Summed over the threads
+		double barrierWait() const;
+		inline double maxBusy() const { return m_maxBusy; }       // Summed over the iterations : slowest thread
+		inline double meanBusy() const { return m_meanBusy; }     // Average thread
+		inline double minBusy() const { return m_minBusy; }       // Fastest thread
+		inline double imbalance() const { return m_maxBusy - m_meanBusy; }// Time the region lasts beyond a perfect balance
+
+private:
+		struct alignas(64) ThreadTimes {
+			double busy = 0;         // Time spent inside kernels
+			double region = 0;       // Time spent inside the region, including the closing barrier
+			double iterationBusy = 0;// busy since the last endIteration()
+		};
+
+		std::string m_tag;
+		std::vector<ThreadTimes> m_threadTimes;
+		uint32_t m_iterations = 0;
+		double m_maxBusy = 0;
+		double m_meanBusy = 0;
+		double m_minBusy = 0;
+	};
+
+	//---------------------------------------------------------------
+
+	class TileScheduler {
+		// Splits a loop of N items (faces or elements) into cache sized tiles and hands them
+		// to the OpenMP team as tasks (taskloop). Idle threads pick up the remaining tiles, so
+		// expensive boundary faces no longer stall a whole static chunk.
+		// run() must be called from inside a parallel region (it is an orphaned worksharing construct)
+
+public:
+		TileScheduler(const std::string &tag, uint32_t numThreads, size_t numItems, size_t bytesPerItem, uint32_t tileSize = 0);
+
+		template<class Kernel>
+		void run(const Kernel &kernel);// kernel(begin, end) is called once per tile
+
+		inline void resetStats() { m_stats.reset(); }
+		void report(std::ostream &) const;// Per-thread busy/idle time since last reset
+		inline RegionStats &stats() { return m_stats; }
+		inline const RegionStats &stats() const { return m_stats; }
+
+		inline size_t numTiles() const { return m_tiles.size() - 1; }
+		inline uint32_t tileBegin(size_t tile) const { return m_tiles[tile]; }
+		inline uint32_t tileEnd(size_t tile) const { return m_tiles[tile + 1]; }
+		inline uint32_t tileSize() const { return m_tileSize; }
+
+		// Items per tile so one tile's working set fits in half of the L2 cache
+		static uint32_t cacheTileSize(size_t bytesPerItem);
+
+private:
+		uint32_t m_numThreads;
+		uint32_t m_tileSize;
+		std::vector<uint32_t> m_tiles;// Tile boundaries [0, t1, t2, ..., N]
+		RegionStats m_stats;
+	};
+
+	//---------------------------------------------------------------
+	template<class Kernel>
+	void TileScheduler::run(const Kernel &kernel) {
+		const uint32_t threadID = omp_get_thread_num();
+		const double regionStart = omp_get_wtime();
+		const size_t nTiles = numTiles();
+
+#pragma omp single
+		{
+#pragma omp taskloop grainsize(1) default(none) shared(kernel) firstprivate(nTiles)
+			for (size_t tile = 0; tile < nTiles; tile++) {
+				const double tileStart = omp_get_wtime();
+				kernel(m_tiles[tile], m_tiles[tile + 1]);
+				m_stats.addBusy(omp_get_thread_num(), omp_get_wtime() - tileStart);
+			}
+		}
+
+		m_stats.addRegion(threadID, omp_get_wtime() - regionStart);
+	}
+
+}// namespace ees2d::solver
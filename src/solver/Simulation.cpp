@@ -33,6 +33,7 @@ Simulation::Simulation(ees2d::mesh::Mesh &mesh, ees2d::io::InputParser &simParam
 	// Output paths
 	residualPath = simParameters.m_outputResidual;
 	pressurePath = simParameters.m_outputPressure;
+	historyPath = simParameters.m_historyFile;
 	meshPath = simParameters.m_meshFile;
 
 	//Initialize freestream values and simulation parameters
@@ -46,6 +47,10 @@ Simulation::Simulation(ees2d::mesh::Mesh &mesh, ees2d::io::InputParser &simParam
 	MachInf = simParameters.m_velocity/(soundSpeedInf);
 	aoa = simParameters.m_aoa;
 	threadNum = simParameters.m_threads;
+	tileSize = simParameters.m_tileSize;
+	schedule = simParameters.m_schedule;
+	hardwareCounters = simParameters.m_hardwareCounters == "TRUE";
+	loadBalanceReport = simParameters.m_loadBalanceReport == "TRUE";
 
 
 	tempInf = simParameters.m_Temp;
@@ -76,6 +81,7 @@ Simulation::Simulation(ees2d::mesh::Mesh &mesh, ees2d::io::InputParser &simParam
 
   // fill solution vectors with Initial Conditions
 	CL = 0;
+	CD = 0;
 	std::fill(u.begin(), u.end(), uInf);
 	std::fill(v.begin(), v.end(), vInf);
 	std::fill(Mach.begin(),Mach.end(),MachInf);
@@ -87,4 +93,21 @@ Simulation::Simulation(ees2d::mesh::Mesh &mesh, ees2d::io::InputParser &simParam
 	std::fill(convectiveFluxes.begin(),convectiveFluxes.end(),ConvectiveFlux(0,0,0,0));
 	std::fill(conservativeVariables.begin(),conservativeVariables.end(),ConservativeVariables(rhoInf,rhoInf*uInf,rhoInf*vInf,rhoInf*E[0]));
 
-}
\ No newline at end of file
+}
+
+//-----------------------------------------------------
+
+void Simulation::reportMemory(ees2d::utils::MemoryReport &report) const {
+	report.addArray("simulation", "u", u);
+	report.addArray("simulation", "v", v);
+	report.addArray("simulation", "rho", rho);
+	report.addArray("simulation", "p", p);
+	report.addArray("simulation", "H", H);
+	report.addArray("simulation", "E", E);
+	report.addArray("simulation", "dt", dt);
+	report.addArray("simulation", "residuals", residuals);
+	report.addArray("simulation", "Mach", Mach);
+	report.addArray("simulation", "convectiveFluxes", convectiveFluxes);
+	report.addArray("simulation", "conservativeVariables", conservativeVariables);
+	report.addArray("simulation", "spectralRadii", spectralRadii);
+}
@@ -33,6 +33,8 @@ namespace ees2d::solver {
 	struct Simulation {
 		Simulation(ees2d::mesh::Mesh &, ees2d::io::InputParser &);
 
+		void reportMemory(ees2d::utils::MemoryReport &report) const;// Bytes held by each vector
+
 
 		// Vectors
 		std::vector<double> u;
@@ -65,11 +67,17 @@ namespace ees2d::solver {
 		double aoa;
 		double aoaRad;
 		double CL;
+		double CD;
 		uint32_t maxIter;
 		uint32_t threadNum;
+		uint32_t tileSize;
+		std::string schedule;
+		bool hardwareCounters;
+		bool loadBalanceReport;// Per-thread tables of the parallel loops, on top of the summary
 
 		std::string residualPath;
 		std::string pressurePath;
+		std::string historyPath;// Binary convergence history, none if empty
     std::string meshPath;
 
 	};
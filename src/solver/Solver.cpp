@@ -22,6 +22,9 @@
 #include "Solver.h"
 #include "BoundaryConditions.h"
 #include "solver/Schemes.h"
+#include "io/HistoryWriter.h"
+#include "utils/Profiler.h"
+#include <chrono>
 #include <cstdlib>
 #include <iomanip>
 #include <omp.h>
@@ -30,27 +33,50 @@
 using namespace ees2d::solver;
 
 Solver::Solver(ees2d::solver::Simulation &sim, ees2d::mesh::Mesh &mesh)
-    : m_sim(sim), m_mesh(mesh) {
+    : m_sim(sim), m_mesh(mesh),
+      m_boundaryScheduler("Boundary face detection", sim.threadNum, mesh.N_faces, 200, sim.tileSize),
+      m_faceScheduler("Face flux loop", sim.threadNum, mesh.N_faces, 200, sim.tileSize),
+      m_gatherScheduler("Residual gather loop", sim.threadNum, mesh.N_elems, 150, sim.tileSize),
+      m_elemScheduler("Element update loop", sim.threadNum, mesh.N_elems, 150, sim.tileSize),
+      m_rmsStats("Residual RMS loop", sim.threadNum), m_coefficients(mesh) {
+
+	m_localFc = std::make_unique<ConvectiveFlux[]>(m_mesh.N_faces);
+	m_localSpectralRadii = std::make_unique<double[]>(m_mesh.N_faces);
+	m_boundaryFaces = std::make_unique<bool[]>(m_mesh.N_faces);
+	m_W0.resize(m_mesh.N_elems);
+	m_rmsPartials.resize(std::max(m_sim.threadNum, 1u));
+
+	if (m_sim.schedule == "TASKGRAPH") {
+		m_taskGraph = std::make_unique<StageTaskGraph>(m_mesh, m_elemScheduler.tileSize(), m_sim.threadNum);
+	}
+
+	if (m_sim.hardwareCounters) {
+		m_counters = std::make_unique<ees2d::utils::PerfCounters>(m_sim.threadNum, std::vector<std::string>{"flux", "scatter", "update", "rms"});
+	}
 }
 
 // ---------------------------------------
 void Solver::run() {
-	// Initialize residual file
-
-	std::ofstream residualStream(m_sim.residualPath);
-
-	residualStream << "--------------------------"
-	               << " RESIDUAL ---------------------------\n";
-	residualStream << "Mesh file : " << m_sim.meshPath << "\n";
-	residualStream << "Mach : " << m_sim.MachInf << "\n";
-	residualStream << "AOA : " << m_sim.aoa << "\n";
-
-	residualStream
-	        << "rho" << std::setw(18)
-	        << "rhoU" << std::setw(15)
-	        << "rhoV" << std::setw(15)
-	        << "rhoH"
-	        << "\n";
+	EES2D_PROFILE_ZONE("solver");
+	// Initialize residual file, unless it is turned off (RESIDUAL_FILE = NONE)
+	const bool residualText = !m_sim.residualPath.empty() && m_sim.residualPath != "NONE";
+	std::ofstream residualStream;
+	if (residualText) {
+		residualStream.open(m_sim.residualPath);
+
+		residualStream << "--------------------------"
+		               << " RESIDUAL ---------------------------\n";
+		residualStream << "Mesh file : " << m_sim.meshPath << "\n";
+		residualStream << "Mach : " << m_sim.MachInf << "\n";
+		residualStream << "AOA : " << m_sim.aoa << "\n";
+
+		residualStream
+		        << "rho" << std::setw(18)
+		        << "rhoU" << std::setw(15)
+		        << "rhoV" << std::setw(15)
+		        << "rhoH"
+		        << "\n";
+	}
 
 	// Initialize iteration number
 	uint32_t iteration = 0;
@@ -67,154 +93,199 @@ void Solver::run() {
 	uint32_t maxIterations = m_sim.maxIter;
 
 
-	// Setup parallelization variables
-
-	const int numTotalFaces = m_mesh.N_faces;
-	const int numTotalElems = m_mesh.N_elems;
-	uint32_t numThreads = m_sim.threadNum;
-	uint32_t restFaces = m_mesh.N_faces % numThreads;
-	uint32_t restElems = m_mesh.N_elems % numThreads;
-	std::vector<double> faceChunks;
-	std::vector<double> elemChunks;
-
-	faceChunks.push_back(0);
-	for (uint32_t i = 1; i < numThreads + 1; i++) {
-		faceChunks.push_back(((numTotalFaces - restFaces) / numThreads) * i);
-	}
-	faceChunks.back() += restFaces;
-
-	elemChunks.push_back(0);
-	for (uint32_t i = 1; i < numThreads + 1; i++) {
-		elemChunks.push_back(((numTotalElems - restElems) / numThreads) * i);
-	}
-	elemChunks.back() += restElems;
-
-
-	// Local Fc for faces (temporary residual vector for parallelization)
-	std::shared_ptr<ConvectiveFlux[]> localFc = std::make_unique<ConvectiveFlux[]>(m_mesh.N_faces);
-
-
 	// Look for boundary faces
-	std::shared_ptr<bool[]> BoundaryFaces = std::make_unique<bool[]>(m_mesh.N_faces);
-#pragma omp parallel for num_threads(numThreads) default(none) shared(BoundaryFaces, faceChunks)
-	for (uint32_t task = 0; task < faceChunks.size() - 1; task++) {
-		for (uint32_t iface = faceChunks[task]; iface < faceChunks[task + 1]; iface++) {
+#pragma omp parallel num_threads(m_sim.threadNum) default(none)
+	m_boundaryScheduler.run([&](uint32_t begin, uint32_t end) {
+		for (uint32_t iface = begin; iface < end; iface++) {
 			uint32_t Elem2ID = m_mesh.FaceToElem(iface, 1);
 			if (Elem2ID == uint32_t(-1) || Elem2ID == uint32_t(-3)) {
-				BoundaryFaces[iface] = true;
+				m_boundaryFaces[iface] = true;
 			} else {
-				BoundaryFaces[iface] = false;
+				m_boundaryFaces[iface] = false;
 			}
 		}
+	});
+	m_boundaryScheduler.stats().endIteration();
+
+	// Binary convergence history, buffered and written in blocks
+	std::unique_ptr<ees2d::io::HistoryWriter> history;
+	if (!m_sim.historyPath.empty()) {
+		history = std::make_unique<ees2d::io::HistoryWriter>(
+		        m_sim.historyPath, std::vector<std::string>{"iteration", "wall_time", "rms_rho", "rms_rhoU", "rms_rhoV", "rms_rhoH", "cfl", "CL", "CD", "cell_iterations_per_s"});
 	}
+	const auto start = std::chrono::steady_clock::now();
 
 
-	while (rms.rho > m_sim.minResidual && iteration < maxIterations) {
-
-		computeResidual(iteration, numThreads, faceChunks, localFc, BoundaryFaces);
+	// One team runs every phase of every iteration, phases are separated by the barriers
+	// of the worksharing constructs instead of forking and joining a new team each time
+#pragma omp parallel num_threads(m_sim.threadNum) default(none) shared(rms, iteration, maxIterations, courant_number, RK5_coeffs, residualText, residualStream, std::cout, history, start)
+	{
+		// Each thread opens the counter group of its own thread
+		if (m_counters) {
+			m_counters->openThread(omp_get_thread_num());
+		}
 
-		//Update delta W of conservative Variables (rho, u ,v, E)
-		if (m_sim.timeIntegration == "RK5") {
-			const std::vector<ConservativeVariables> W0 = m_sim.conservativeVariables;
-			for (auto &coeff : RK5_coeffs) {
-				RK5(iteration, coeff, courant_number, W0, numThreads, faceChunks, elemChunks, localFc, BoundaryFaces);
+		while (rms.rho > m_sim.minResidual && iteration < maxIterations) {
+			EES2D_PROFILE_ZONE("iteration");
+
+			if (m_taskGraph) {
+				// Flux, gather and update of each stage run as a dataflow graph over element partitions
+				const uint32_t numStages = m_sim.timeIntegration == "RK5" ? RK5_coeffs.size() : 1;
+				for (uint32_t stage = 0; stage < numStages; stage++) {
+					const double coeff = RK5_coeffs[stage];
+					m_taskGraph->run([&](uint32_t iface) { computeFaceFlux(iface, iteration); },
+					                 [&](uint32_t begin, uint32_t end) {
+						                 updateResidual(begin, end);
+						                 updateStage(begin, end, coeff, stage, courant_number);
+					                 });
+				}
 			}
-		} else if (m_sim.timeIntegration == "EXPLICIT_EULER") {
-			eulerExplicit(courant_number, numThreads, elemChunks);
-		}
 
-		iteration += 1;
+			//Update delta W of conservative Variables (rho, u ,v, E)
+			else if (m_sim.timeIntegration == "RK5") {
+				computeResidual(iteration);
 
-		findRms(rms);
+				for (uint32_t stage = 0; stage < RK5_coeffs.size(); stage++) {
+					RK5(iteration, RK5_coeffs[stage], stage, courant_number);
+				}
+			} else if (m_sim.timeIntegration == "EXPLICIT_EULER") {
+				computeResidual(iteration);
+				eulerExplicit(courant_number);
+			}
 
-		if (iteration % 50 == 0) {
-			std::cout << "Iteration :" << iteration << std::endl;
-			std::cout << " RMS_rho : " << rms.rho << " | RMS_rho_u : " << rms.rhoU << " | RMS_rho_v : " << rms.rhoV << " | RMS_rho_H : " << rms.rhoH << std::endl;
+			findRms(rms);
+
+#pragma omp single
+			{
+				iteration += 1;
+				EES2D_PROFILE_ITERATION(iteration);
+
+				// Every thread is past the last barrier of the iteration
+				m_faceScheduler.stats().endIteration();
+				m_gatherScheduler.stats().endIteration();
+				m_elemScheduler.stats().endIteration();
+				m_rmsStats.endIteration();
+				if (m_taskGraph) {
+					m_taskGraph->stats().endIteration();
+				}
+
+				if (iteration % 50 == 0) {
+					std::cout << "Iteration :" << iteration << "\n";
+					std::cout << " RMS_rho : " << rms.rho << " | RMS_rho_u : " << rms.rhoU << " | RMS_rho_v : " << rms.rhoV << " | RMS_rho_H : " << rms.rhoH << "\n";
+				}
+
+
+				if (residualText) {
+					residualStream << rms.rho << std::setw(15)
+					               << rms.rhoU << std::setw(15)
+					               << rms.rhoV << std::setw(15)
+					               << rms.rhoH << "\n";
+				}
+
+				if (history) {
+					// The records between two evaluations of the coefficients repeat the last ones
+					if (iteration == 1 || iteration % coefficientPeriod == 0) {
+						m_coefficients.compute(m_sim);
+					}
+					const double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+					const double record[] = {double(iteration), wallTime, rms.rho, rms.rhoU, rms.rhoV, rms.rhoH, courant_number, m_sim.CL, m_sim.CD,
+					                         m_mesh.N_elems * double(iteration) / wallTime};
+					history->append(record, std::size(record));
+				}
+
+				if (m_iterationCallback) {
+					m_iterationCallback(iteration);
+				}
+			}
 		}
-
-
-		residualStream << rms.rho << std::setw(15)
-		               << rms.rhoU << std::setw(15)
-		               << rms.rhoV << std::setw(15)
-		               << rms.rhoH << "\n";
-		//computeCL();
 	}
+	const double loopTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 	residualStream.close();
+
+	// Per-thread load balance of the parallel loops, only summarized unless LOAD_BALANCE_REPORT = TRUE
+	if (m_sim.loadBalanceReport) {
+		m_boundaryScheduler.report(std::cout);
+		m_faceScheduler.report(std::cout);
+		m_gatherScheduler.report(std::cout);
+		m_elemScheduler.report(std::cout);
+		if (m_taskGraph) {
+			m_taskGraph->report(std::cout);
+		}
+		std::cout << "[ " << m_rmsStats.tag() << " ] static split\n";
+		m_rmsStats.report(std::cout);
+	}
+	reportLoadBalance(std::cout, loopTime, iteration);
+	if (m_counters) {
+		m_counters->report(std::cout);
+	}
 }
 
 // -------------------------------------------------------------
-void Solver::computeResidual(uint32_t &iteration,
-                             uint32_t &numThreads,
-                             const std::vector<double> &faceChunks,
-                             std::shared_ptr<ConvectiveFlux[]> localFc,
-                             std::shared_ptr<bool[]> BoundaryFaces) {
-
-	// ID of Elements on both sides of each face
-
+void Solver::computeResidual(uint32_t &iteration) {
+	// Called by every thread of the team
 
-	for (auto &residual : m_sim.residuals) {
-		residual.reset();
-	}
+	m_faceScheduler.run([&](uint32_t begin, uint32_t end) { computeFaceFluxes(begin, end, iteration); });
 
+	m_gatherScheduler.run([&](uint32_t begin, uint32_t end) { updateResidual(begin, end); });
+}
 
-	for (auto &spec : m_sim.spectralRadii) {
-		spec = 0;
+// -------------------------------------------------------------
+void Solver::computeFaceFluxes(uint32_t begin, uint32_t end, uint32_t &iteration) {
+	EES2D_PROFILE_ZONE("flux");
+	ees2d::utils::PerfCounters::Scope counters(m_counters.get(), omp_get_thread_num(), FluxPhase, end - begin);
+	for (uint32_t iface = begin; iface < end; iface++) {
+		computeFaceFlux(iface, iteration);
 	}
+}
 
-#pragma omp parallel for num_threads(numThreads) default(none) shared(localFc, BoundaryFaces, faceChunks, iteration, std::cerr)
-	for (uint32_t task = 0; task < faceChunks.size() - 1; task++) {
-
-
-		for (uint32_t iface = faceChunks[task]; iface < faceChunks[task + 1]; iface++) {
+// -------------------------------------------------------------
+void Solver::computeFaceFlux(const uint32_t &iface, uint32_t &iteration) {
 
-			uint32_t Elem1ID = m_mesh.FaceToElem(iface, 0);
-			uint32_t Elem2ID = m_mesh.FaceToElem(iface, 1);
+	// ID of Elements on both sides of each face
+	uint32_t Elem1ID = m_mesh.FaceToElem(iface, 0);
+	uint32_t Elem2ID = m_mesh.FaceToElem(iface, 1);
 
-			faceParams faceP;
-			// Get the elements IDs connected to the face
+	faceParams faceP;
+	// Get the elements IDs connected to the face
 
-			if (Elem2ID < Elem1ID) {
-				std::swap(Elem2ID, Elem1ID);
-			}
+	if (Elem2ID < Elem1ID) {
+		std::swap(Elem2ID, Elem1ID);
+	}
 
-			// Elem 1ID is the looped node
+	// Elem 1ID is the looped node
 
-			//Initialize Convective Flux
-			ConvectiveFlux Fc;
+	//Initialize Convective Flux
+	ConvectiveFlux Fc;
 
 
-			// if boundary cells connected to the face
-			if (BoundaryFaces[iface] == true) {
+	// if boundary cells connected to the face
+	if (m_boundaryFaces[iface] == true) {
 
-				Fc = computeBCFlux(Elem1ID, Elem2ID, faceP, iface);
+		Fc = computeBCFlux(Elem1ID, Elem2ID, faceP, iface);
 
-			}
+	}
 
 
-			// if internal face
-			else {
-				Fc = scheme::RoeScheme(Elem1ID,
-				                       Elem2ID,
-				                       iface,
-				                       faceP,
-				                       m_sim,
-				                       m_mesh);
-			}
+	// if internal face
+	else {
+		Fc = scheme::RoeScheme(Elem1ID,
+		                       Elem2ID,
+		                       iface,
+		                       faceP,
+		                       m_sim,
+		                       m_mesh);
+	}
 
-			if (std::isnan(Fc.m_rhoV)) {
-				std::cerr << "Error : nan flux found at iteration " << iteration << " and elem : " << Elem1ID << std::endl;
-				std::exit(EXIT_FAILURE);
-			}
+	if (std::isnan(Fc.m_rhoV)) {
+		std::cerr << "Error : nan flux found at iteration " << iteration << " and elem : " << Elem1ID << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
 
-			// Update spectral radiation for timestep calculation
-			updateSpectralRadii(Elem1ID, Elem2ID, faceP, iface);
-			//std::cout << faceP.rho << "/" << faceP.u << "/" << faceP.v << "/" << faceP.p << std::endl;
+	// Update spectral radiation for timestep calculation
+	updateSpectralRadii(Elem1ID, Elem2ID, faceP, iface);
 
-			// Update residual of elements connected to face
-			localFc[iface] = Fc;
-		}
-	}
-	updateResidual(localFc, BoundaryFaces);
+	// Update residual of elements connected to face
+	m_localFc[iface] = Fc;
 }
 
 
@@ -258,175 +329,188 @@ ConvectiveFlux Solver::computeBCFlux(const uint32_t &Elem1ID, const uint32_t &El
 
 //-------------------------------------------
 
-void Solver::updateResidual(std::shared_ptr<ConvectiveFlux[]> localFc, std::shared_ptr<bool[]> BoundaryFaces) {
-	// Calculating Residual if BC
-	for (uint32_t iface = 0; iface < m_mesh.N_faces; iface++) {
-		uint32_t Elem1ID = m_mesh.FaceToElem(iface, 0);
-		uint32_t Elem2ID = m_mesh.FaceToElem(iface, 1);
-
-		if (BoundaryFaces[iface] == true) {
+void Solver::updateResidual(uint32_t begin, uint32_t end) {
+	// Gather the fluxes and spectral radii of the faces of elements [begin, end)
+	EES2D_PROFILE_ZONE("scatter");
+	ees2d::utils::PerfCounters::Scope counters(m_counters.get(), omp_get_thread_num(), ScatterPhase, end - begin);
+	for (uint32_t ielem = begin; ielem < end; ielem++) {
+		Residual residual;
+		double spectralRadius = 0;
 
-			m_sim.residuals[Elem1ID] += (localFc[iface] * m_mesh.FaceSurface(iface));
+		for (uint32_t localFace = 0; localFace < m_mesh.NbOfNodesSurroundingElem(ielem); localFace++) {
+			const uint32_t &iface = m_mesh.ElemToFace(ielem, localFace);
 
-			// Calculating Residual if internal face
-		} else {
-			m_sim.residuals[Elem1ID] += (localFc[iface] * m_mesh.FaceSurface(iface));
-			m_sim.residuals[Elem2ID] -= (localFc[iface] * m_mesh.FaceSurface(iface));
+			// The flux is oriented from the first element of the face to the second one
+			if (m_mesh.FaceToElem(iface, 0) == ielem) {
+				residual += (m_localFc[iface] * m_mesh.FaceSurface(iface));
+			} else {
+				residual -= (m_localFc[iface] * m_mesh.FaceSurface(iface));
+			}
+			spectralRadius += m_localSpectralRadii[iface];
 		}
+
+		m_sim.residuals[ielem] = residual;
+		m_sim.spectralRadii[ielem] = spectralRadius;
 	}
 }
 
 
 // --------------------------------------
-void Solver::updateSpectralRadii(const uint32_t &Elem1ID, const uint32_t &Elem2ID, Solver::faceParams &faceP, const uint32_t &iface) {
-	//double c = sqrt(m_sim.gammaInf * (faceP.p / faceP.rho));
-	//double elemSpectralRadiiX = 0.5 * (std::abs(faceP.u) + c ) * std::abs(m_mesh.FaceVector(iface).x * m_mesh.FaceSurface(iface));
-	//double elemSpectralRadiiY = 0.5 * (std::abs(faceP.v) + c ) *std::abs(m_mesh.FaceVector(iface).y * m_mesh.FaceSurface(iface));
-	double elemSpectralRadii = (std::abs((faceP.u * m_mesh.FaceVector(iface).x + faceP.v * m_mesh.FaceVector(iface).y)) +
-	                            sqrt(m_sim.gammaInf * (faceP.p / faceP.rho))) *
-	                           m_mesh.FaceSurface(iface);
-
-
-	if (Elem2ID == uint32_t(-1) || Elem2ID == uint32_t(-3)) {
-		m_sim.spectralRadii[Elem1ID] += elemSpectralRadii;
-
-	} else {
-
-		m_sim.spectralRadii[Elem1ID] += elemSpectralRadii;
-		m_sim.spectralRadii[Elem2ID] += elemSpectralRadii;
-	}
+void Solver::updateSpectralRadii(const uint32_t &, const uint32_t &, Solver::faceParams &faceP, const uint32_t &iface) {
+	// Only the face value is stored here, updateResidual() adds it to the elements on both sides
+	m_localSpectralRadii[iface] = (std::abs((faceP.u * m_mesh.FaceVector(iface).x + faceP.v * m_mesh.FaceVector(iface).y)) +
+	                               sqrt(m_sim.gammaInf * (faceP.p / faceP.rho))) *
+	                              m_mesh.FaceSurface(iface);
 }
 
 //----------------------------------------------------------------
-void Solver::eulerExplicit(double courantNumber, uint32_t &numThreads, const std::vector<double> &elemChunks) {
-	// Update time
-	updateLocalTimeSteps(courantNumber);
-
-	TimeIntegration::explicitEuler(m_sim, m_mesh);
-	Solver::updateVariables(numThreads, elemChunks);
+void Solver::eulerExplicit(double courantNumber) {
+	m_elemScheduler.run([&](uint32_t begin, uint32_t end) { updateStage(begin, end, 1, 0, courantNumber); });
 }
 // ----------------------------------------------------------------
-void Solver::RK5(uint32_t &iteration,
-                 const double &coeff, double courantNumber,
-                 const std::vector<ConservativeVariables> &W0,
-                 uint32_t &numThreads,
-                 const std::vector<double> &faceChunks,
-                 const std::vector<double> &elemChunks,
-                 std::shared_ptr<ConvectiveFlux[]> localFc,
-                 std::shared_ptr<bool[]> BoundaryFaces) {
-	// Update time
-	updateLocalTimeSteps(courantNumber);
+void Solver::RK5(uint32_t &iteration, const double &coeff, uint32_t stage, double courantNumber) {
+	m_elemScheduler.run([&](uint32_t begin, uint32_t end) { updateStage(begin, end, coeff, stage, courantNumber); });
 
-	TimeIntegration::RK5(m_sim, m_mesh, coeff, W0);
+	if (coeff != 1) {
+		computeResidual(iteration);
+	}
+}
+// ----------------------------------------------------------------
+void Solver::updateStage(uint32_t begin, uint32_t end, const double &coeff, uint32_t stage, double courantNumber) {
+	// Time step, stage update and primitive variables only touch the element itself,
+	// so they run back to back on elements [begin, end) without a barrier in between
+	EES2D_PROFILE_ZONE("update");
+	ees2d::utils::PerfCounters::Scope counters(m_counters.get(), omp_get_thread_num(), UpdatePhase, end - begin);
 
-	Solver::updateVariables(numThreads, elemChunks);
+	// Update time
+	{
+		EES2D_PROFILE_ZONE("dt");
+		updateLocalTimeSteps(courantNumber, begin, end);
+	}
 
-	if (coeff != 1) {
-		computeResidual(iteration, numThreads, faceChunks, localFc, BoundaryFaces);
+	if (m_sim.timeIntegration == "RK5") {
+		if (stage == 0) {
+			std::copy(m_sim.conservativeVariables.begin() + begin, m_sim.conservativeVariables.begin() + end, m_W0.begin() + begin);
+		}
+		TimeIntegration::RK5(m_sim, m_mesh, coeff, m_W0, begin, end);
+	} else {
+		TimeIntegration::explicitEuler(m_sim, m_mesh, begin, end);
 	}
+
+	updateVariables(begin, end);
 }
 //----------------------------------------------------------------
 
-void Solver::updateLocalTimeSteps(double &courantNumber) {
-	for (uint32_t ielem = 0; ielem < m_sim.dt.size(); ielem++) {
+void Solver::updateLocalTimeSteps(double &courantNumber, uint32_t begin, uint32_t end) {
+	for (uint32_t ielem = begin; ielem < end; ielem++) {
 		m_sim.dt[ielem] = courantNumber * m_mesh.CvolumeArea(ielem) / (m_sim.spectralRadii[ielem]);
 	}
 }
 
 // ----------------------------------------------------
-
-
-void Solver::updateVariables(uint32_t &numThreads,
-                             const std::vector<double> &elemChunks) {
-#pragma omp parallel for num_threads(numThreads) default(none) shared(elemChunks, std::cerr)
-	for (uint32_t task = 0; task < elemChunks.size() - 1; task++) {
-
-
-		for (uint32_t elem = elemChunks[task]; elem < elemChunks[task + 1]; elem++) {
-			m_sim.rho[elem] = m_sim.conservativeVariables[elem].m_rho;
-			if (std::isnan(m_sim.rho[elem])) {
-				std::cerr << "Error : nan rho variable found at elem : " << elem << std::endl;
-				std::exit(EXIT_FAILURE);
-			}
-			m_sim.u[elem] = m_sim.conservativeVariables[elem].m_rho_u / m_sim.rho[elem];
-			m_sim.v[elem] = m_sim.conservativeVariables[elem].m_rho_v / m_sim.rho[elem];
-			m_sim.E[elem] = m_sim.conservativeVariables[elem].m_rho_E / m_sim.rho[elem];
-			m_sim.p[elem] = (m_sim.gammaInf - 1) * m_sim.rho[elem] * (m_sim.E[elem] - ((m_sim.u[elem] * m_sim.u[elem] + m_sim.v[elem] * m_sim.v[elem]) / 2));
-
-			m_sim.H[elem] = m_sim.E[elem] + (m_sim.p[elem] / m_sim.rho[elem]);
-			m_sim.Mach[elem] = std::sqrt(m_sim.u[elem] * m_sim.u[elem] + m_sim.v[elem] * m_sim.v[elem]) / std::sqrt(m_sim.gammaInf * (m_sim.p[elem] / m_sim.rho[elem]));
+void Solver::updateVariables(uint32_t begin, uint32_t end) {
+	for (uint32_t elem = begin; elem < end; elem++) {
+		m_sim.rho[elem] = m_sim.conservativeVariables[elem].m_rho;
+		if (std::isnan(m_sim.rho[elem])) {
+			std::cerr << "Error : nan rho variable found at elem : " << elem << std::endl;
+			std::exit(EXIT_FAILURE);
 		}
+		m_sim.u[elem] = m_sim.conservativeVariables[elem].m_rho_u / m_sim.rho[elem];
+		m_sim.v[elem] = m_sim.conservativeVariables[elem].m_rho_v / m_sim.rho[elem];
+		m_sim.E[elem] = m_sim.conservativeVariables[elem].m_rho_E / m_sim.rho[elem];
+		m_sim.p[elem] = (m_sim.gammaInf - 1) * m_sim.rho[elem] * (m_sim.E[elem] - ((m_sim.u[elem] * m_sim.u[elem] + m_sim.v[elem] * m_sim.v[elem]) / 2));
+
+		m_sim.H[elem] = m_sim.E[elem] + (m_sim.p[elem] / m_sim.rho[elem]);
+		m_sim.Mach[elem] = std::sqrt(m_sim.u[elem] * m_sim.u[elem] + m_sim.v[elem] * m_sim.v[elem]) / std::sqrt(m_sim.gammaInf * (m_sim.p[elem] / m_sim.rho[elem]));
 	}
 }
 
 // ---------------------------------------------------
 void Solver::findRms(Solver::ResidualRMS &RMS) {
+	// Called by every thread of the team, each one sums its share of the elements
+	EES2D_PROFILE_ZONE("rms");
+	const double regionStart = omp_get_wtime();
 	double sumRhoResidual = 0;
 	double sumRhoUResidual = 0;
 	double sumRhoVResidual = 0;
 	double sumRhoHResidual = 0;
 
-
-	for (auto &ResidualinElement : m_sim.residuals) {
-		sumRhoResidual += (ResidualinElement.m_rhoV_residual * ResidualinElement.m_rhoV_residual);
-		sumRhoUResidual += (ResidualinElement.m_rho_uV_residual * ResidualinElement.m_rho_uV_residual);
-		sumRhoVResidual += (ResidualinElement.m_rho_vV_residual * ResidualinElement.m_rho_vV_residual);
-		sumRhoHResidual += (ResidualinElement.m_rho_HV_residual * ResidualinElement.m_rho_HV_residual);
+	{
+		// Static schedule : the thread's share is N_elems / threads elements, give or take one
+		ees2d::utils::PerfCounters::Scope counters(m_counters.get(), omp_get_thread_num(), RmsPhase, m_mesh.N_elems / omp_get_num_threads());
+		const double loopStart = omp_get_wtime();
+
+#pragma omp for schedule(static) nowait
+		for (uint32_t ielem = 0; ielem < m_mesh.N_elems; ielem++) {
+			const Residual &ResidualinElement = m_sim.residuals[ielem];
+			sumRhoResidual += (ResidualinElement.m_rhoV_residual * ResidualinElement.m_rhoV_residual);
+			sumRhoUResidual += (ResidualinElement.m_rho_uV_residual * ResidualinElement.m_rho_uV_residual);
+			sumRhoVResidual += (ResidualinElement.m_rho_vV_residual * ResidualinElement.m_rho_vV_residual);
+			sumRhoHResidual += (ResidualinElement.m_rho_HV_residual * ResidualinElement.m_rho_HV_residual);
+		}
+		m_rmsStats.addBusy(omp_get_thread_num(), omp_get_wtime() - loopStart);
 	}
 
-	RMS.rho = sqrt((1.0 / m_mesh.N_elems) * sumRhoResidual);
-	RMS.rhoU = sqrt((1.0 / m_mesh.N_elems) * sumRhoUResidual);
-	RMS.rhoV = sqrt((1.0 / m_mesh.N_elems) * sumRhoVResidual);
-	RMS.rhoH = sqrt((1.0 / m_mesh.N_elems) * sumRhoHResidual);
+	// Partial sums are added in thread order, so the RMS does not depend on which thread finishes first
+	RmsPartial &partial = m_rmsPartials[omp_get_thread_num()];
+	partial.sums[0] = sumRhoResidual;
+	partial.sums[1] = sumRhoUResidual;
+	partial.sums[2] = sumRhoVResidual;
+	partial.sums[3] = sumRhoHResidual;
+
+#pragma omp barrier
+#pragma omp single
+	{
+		double sums[4] = {0, 0, 0, 0};
+		for (int thread = 0; thread < omp_get_num_threads(); thread++) {
+			for (uint32_t variable = 0; variable < 4; variable++) {
+				sums[variable] += m_rmsPartials[thread].sums[variable];
+			}
+		}
+		RMS.rho = sqrt((1.0 / m_mesh.N_elems) * sums[0]);
+		RMS.rhoU = sqrt((1.0 / m_mesh.N_elems) * sums[1]);
+		RMS.rhoV = sqrt((1.0 / m_mesh.N_elems) * sums[2]);
+		RMS.rhoH = sqrt((1.0 / m_mesh.N_elems) * sums[3]);
+	}
+	m_rmsStats.addRegion(omp_get_thread_num(), omp_get_wtime() - regionStart);
 }
 // ----------------------------------------------------
-void Solver::computeCL() {
-
-	std::vector<double>  Cps;
-  double u_sqrd = m_sim.uInf * m_sim.uInf + m_sim.vInf * m_sim.vInf;
-  double CL=0;
-	for (uint32_t iface = 0; iface < m_mesh.N_faces; iface++) {
-		uint32_t Elem1ID = m_mesh.FaceToElem(iface, 0);
-		uint32_t Elem2ID = m_mesh.FaceToElem(iface, 1);
-		if (Elem2ID == uint32_t(-1)) {
-
-			double pinf = 1.0;
-			double p = m_sim.p[Elem1ID];
-
-			double Mach = m_sim.Mach[Elem1ID];
-
-			double Cp = (p - pinf) / (0.5 * 1 * u_sqrd);
-
-
-			// COmpressibility correction (between M 0 and 0.7)
-//			if (Mach < 0.7) {
-//				Cp = Cp / sqrt(1 - Mach * Mach);
-//			}
-
-			Cps.push_back(Cp);
-
-			// Computations for lift and drag forces
-			outwardNormal(Elem1ID, iface);
-
-			CL += Cp * m_mesh.FaceSurface(iface) * (m_mesh.FaceVector(iface).y);
-		}
+void Solver::reportLoadBalance(std::ostream &os, double loopTime, uint32_t iterations) const {
+	// Per iteration : busy time of the slowest thread, how much longer it is than the average thread,
+	// and the time an average thread waits at the barriers of the region (imbalance and scheduling)
+	if (iterations == 0) {
+		return;
+	}
+	const double iterationTime = loopTime / iterations;
+	os << "[ Load balance ] " << iterations << " iterations, " << iterationTime * 1e3 << " ms per iteration, " << m_sim.threadNum << " threads\n";
+	os << std::setw(26) << "region" << std::setw(15) << "max busy (ms)" << std::setw(16) << "imbalance (ms)" << std::setw(19)
+	   << "barrier wait (ms)" << std::setw(10) << "lost (%)" << "\n";
+
+	// The task graph replaces the flux, gather and update loops
+	std::vector<const RegionStats *> regions = {&m_faceScheduler.stats(), &m_gatherScheduler.stats(), &m_elemScheduler.stats()};
+	if (m_taskGraph) {
+		regions = {&m_taskGraph->stats()};
+	}
+	regions.push_back(&m_rmsStats);
+
+	double lost = 0;
+	for (const RegionStats *stats : regions) {
+		const double wait = stats->barrierWait() / m_sim.threadNum / iterations;
+		os << std::setw(26) << stats->tag() << std::setw(15) << stats->maxBusy() / iterations * 1e3 << std::setw(16)
+		   << stats->imbalance() / iterations * 1e3 << std::setw(19) << wait * 1e3 << std::setw(10) << 100 * wait / iterationTime << "\n";
+		lost += wait;
 	}
-  m_sim.CL = CL;
+	os << std::setw(26) << "total" << std::setw(15) << "" << std::setw(16) << "" << std::setw(19) << lost * 1e3 << std::setw(10)
+	   << 100 * lost / iterationTime << "\n";
 }
 // ----------------------------------------------------
-void Solver::outwardNormal(const uint32_t &Elem1ID, const uint32_t &iface) {
-  /*
-   * Orient the normal outward of the airfoil surface
-   */
-  std::vector<double> midFaceToElem1{m_mesh.CvolumeCentroid(Elem1ID).x - m_mesh.FaceMidPoint(iface).x,
-                                     m_mesh.CvolumeCentroid(Elem1ID).y - m_mesh.FaceMidPoint(iface).y};
-  double midFaceToElemNorm = std::sqrt(midFaceToElem1[0] * midFaceToElem1[0] + midFaceToElem1[1] * midFaceToElem1[1]);
-  double DotProduct = midFaceToElem1[0] * m_mesh.FaceVector(iface).x + midFaceToElem1[1] * m_mesh.FaceVector(iface).y;
-  double angle = std::acos(DotProduct / (midFaceToElemNorm * 1)) * (180 / M_PI);
-  if (angle <  80) {
-    m_mesh.FaceVector(iface).x *= -1;
-    m_mesh.FaceVector(iface).y *= -1;
-  }
+void Solver::reportMemory(ees2d::utils::MemoryReport &report) const {
+	using ees2d::utils::MemoryReport;
+	report.add("solver", "localFc", MemoryReport::blockBytes(m_mesh.N_faces * sizeof(ConvectiveFlux)));
+	report.add("solver", "localSpectralRadii", MemoryReport::blockBytes(m_mesh.N_faces * sizeof(double)));
+	report.add("solver", "boundaryFaces", MemoryReport::blockBytes(m_mesh.N_faces * sizeof(bool)));
+	report.addArray("solver", "W0", m_W0);
+	report.addArray("solver", "wallFaces", m_coefficients.wallFaces());
 }
 //
 
@@ -23,8 +23,17 @@
 
 #include "solver/ConservativeVariables.h"
 #include "solver/ConvectiveFlux.h"
+#include "solver/ForceCoefficients.h"
+#include "solver/Scheduler.h"
 #include "solver/Simulation.h"
+#include "solver/TaskGraph.h"
 #include "solver/TimeIntegration.h"
+#include "utils/MemoryReport.h"
+#include "utils/PerfCounters.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
 
 namespace ees2d::solver {
 
@@ -49,28 +58,24 @@ public:
 		};
 
 		void run();
-		void computeResidual(uint32_t& iteration, uint32_t& numThreads, const std::vector<double>& faceChunks,std::shared_ptr<ConvectiveFlux[]> localFc,std::shared_ptr<bool[]> BoundaryFaces);
+		// Called by one thread at the end of every iteration, with the number of iterations done
+		inline void setIterationCallback(std::function<void(uint32_t)> callback) { m_iterationCallback = std::move(callback); }
+		void computeResidual(uint32_t &iteration);
+		void computeFaceFluxes(uint32_t begin, uint32_t end, uint32_t &iteration);// Flux of faces [begin, end), one scheduler tile
+		void computeFaceFlux(const uint32_t &iface, uint32_t &iteration);
 		ConvectiveFlux computeBCFlux(const uint32_t &, const uint32_t &, Solver::faceParams &, const uint32_t &);
-		void updateResidual(std::shared_ptr<ConvectiveFlux[]> localFc,std::shared_ptr<bool[]> BoundaryFaces);
+		void updateResidual(uint32_t begin, uint32_t end);// Gather face fluxes into elements [begin, end)
 		void updateSpectralRadii(const uint32_t &Elem1ID, const uint32_t &Elem2ID, Solver::faceParams &faceP, const uint32_t &iface);
-		void updateLocalTimeSteps(double &courantNumber);
-		
-		void RK5(uint32_t& iteration,
-				const double &coeff,
-				double courantNumber,
-				const std::vector<ConservativeVariables> &W0,
-				uint32_t &numThreads,
-				const std::vector<double> &faceChunks,
-				const std::vector<double> &elemChunks,
-				std::shared_ptr<ConvectiveFlux[]> localFc,
-				std::shared_ptr<bool[]> BoundaryFaces);
-
-		void outwardNormal(const uint32_t &Elem1ID, const uint32_t &iface);
-		void computeCL();
-
-		void eulerExplicit(double courantNumber,uint32_t &numThreads,const std::vector<double> &elemChunks);
-		void updateVariables(uint32_t &numThreads, 
-							const std::vector<double> &elemChunks);
+		void updateLocalTimeSteps(double &courantNumber, uint32_t begin, uint32_t end);
+
+		// Phases of an iteration, called by every thread of the team opened in run()
+		void RK5(uint32_t &iteration, const double &coeff, uint32_t stage, double courantNumber);
+
+		// Normal of a wall face pointing out of the airfoil, the mesh normal is left as is
+
+		void eulerExplicit(double courantNumber);
+		void updateStage(uint32_t begin, uint32_t end, const double &coeff, uint32_t stage, double courantNumber);// dt, RK stage and primitives of elements [begin, end)
+		void updateVariables(uint32_t begin, uint32_t end);
 
 
 		// ------------------------
@@ -84,11 +89,43 @@ public:
 		// compute residual with Root mean squared
 		void findRms(ResidualRMS &Rms);
 
+		void reportMemory(ees2d::utils::MemoryReport &report) const;// Bytes held by the work arrays of the solver
+
+		// Time lost waiting at the barriers of each parallel region, against the iteration time
+		void reportLoadBalance(std::ostream &os, double loopTime, uint32_t iterations) const;
+
 
 private:
 		ees2d::solver::Simulation &m_sim;
 		ees2d::mesh::Mesh &m_mesh;
 
+		TileScheduler m_boundaryScheduler;// Tiles of faces for the boundary face detection
+		TileScheduler m_faceScheduler;    // Tiles of faces for the flux loop
+		TileScheduler m_gatherScheduler;  // Tiles of elements for the residual gather loop
+		TileScheduler m_elemScheduler;    // Tiles of elements for the update loop
+		RegionStats m_rmsStats;           // Per-thread times of the residual RMS loop (static split)
+		std::unique_ptr<StageTaskGraph> m_taskGraph;// Only built when SOLVER_SCHEDULE = TASKGRAPH
+
+		// Hardware counters of the phases, only built when HARDWARE_COUNTERS = TRUE
+		// With the task graph the flux is computed one face at a time and is not counted
+		enum Phase : uint32_t { FluxPhase,
+			                    ScatterPhase,
+			                    UpdatePhase,
+			                    RmsPhase };
+		std::unique_ptr<ees2d::utils::PerfCounters> m_counters;
+
+		std::shared_ptr<ConvectiveFlux[]> m_localFc;     // Flux of each face (temporary residual vector for parallelization)
+		std::shared_ptr<double[]> m_localSpectralRadii;   // Spectral radius of each face, scattered with the fluxes
+		std::shared_ptr<bool[]> m_boundaryFaces;          // True if the face lies on a boundary
+		std::vector<ConservativeVariables> m_W0;          // Conservative variables at the start of the RK iteration
+		struct alignas(64) RmsPartial {
+			double sums[4] = {0, 0, 0, 0};
+		};
+		std::vector<RmsPartial> m_rmsPartials;            // Sums of squared residuals of each thread, added in thread order
+		std::function<void(uint32_t)> m_iterationCallback;// Periodic output, run between two iterations
+		ForceCoefficients m_coefficients;                 // Lift and drag of the history, shared with PostProcess
+		static constexpr uint32_t coefficientPeriod = 10; // Iterations between two CL / CD of the history
+
 
 	};
 
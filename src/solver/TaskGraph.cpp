@@ -0,0 +1,88 @@
+/*
+* This file is part of EES2D.
+*
+*   EES2D is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   EES2D is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+*
+* ---------------------------------------------------------------------
+*
+* Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+*/
+
+#include "solver/TaskGraph.h"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+
+using ees2d::solver::StageTaskGraph;
+
+
+StageTaskGraph::StageTaskGraph(ees2d::mesh::Mesh &mesh, uint32_t partitionSize, uint32_t numThreads)
+    : m_stats("Stage task graph", numThreads) {
+
+	partitionSize = std::max(partitionSize, 1u);
+	for (uint32_t begin = 0; begin < mesh.N_elems; begin += partitionSize) {
+		m_partitions.push_back(begin);
+	}
+	m_partitions.push_back(mesh.N_elems);
+
+	auto partitionOf = [&](uint32_t ielem) { return ielem / partitionSize; };
+
+	// Group faces by (partition of first element, kind). The kind is the second element of the
+	// face for boundaries (BC ID) and 0 for interior faces, so each BC type gets its own task
+	std::vector<std::map<uint32_t, std::vector<uint32_t>>> groups(numPartitions());
+	for (uint32_t iface = 0; iface < mesh.N_faces; iface++) {
+		const uint32_t elem1 = mesh.FaceToElem(iface, 0);
+		const uint32_t elem2 = mesh.FaceToElem(iface, 1);
+		const uint32_t kind = elem2 < mesh.N_elems ? 0 : elem2;
+		groups[partitionOf(elem1)][kind].push_back(iface);
+	}
+
+	m_taskFaceIndex.push_back(0);
+	m_targetIndex.push_back(0);
+	m_pendingInit.assign(numPartitions(), 0);
+
+	for (auto &partitionGroups : groups) {
+		for (auto &[kind, faces] : partitionGroups) {
+			m_taskFaces.insert(m_taskFaces.end(), faces.begin(), faces.end());
+			m_taskFaceIndex.push_back(m_taskFaces.size());
+
+			// Partitions touched by the faces of this task
+			std::vector<uint32_t> targets;
+			for (auto &iface : faces) {
+				targets.push_back(partitionOf(mesh.FaceToElem(iface, 0)));
+				if (mesh.FaceToElem(iface, 1) < mesh.N_elems) {
+					targets.push_back(partitionOf(mesh.FaceToElem(iface, 1)));
+				}
+			}
+			std::sort(targets.begin(), targets.end());
+			targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+
+			for (auto &partition : targets) {
+				m_pendingInit[partition] += 1;
+			}
+			m_targets.insert(m_targets.end(), targets.begin(), targets.end());
+			m_targetIndex.push_back(m_targets.size());
+		}
+	}
+
+	m_pending = std::make_unique<std::atomic<uint32_t>[]>(numPartitions());
+
+	std::cout << std::setw(40) << "Stage task graph : " << numPartitions() << " partitions, " << numTasks() << " flux tasks\n";
+}
+
+//---------------------------------------------------------------
+void StageTaskGraph::report(std::ostream &os) const {
+	os << "[ " << m_stats.tag() << " ] " << numPartitions() << " partitions, " << numTasks() << " flux tasks\n";
+	m_stats.report(os);
+}
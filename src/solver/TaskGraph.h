@@ -0,0 +1,105 @@
+/*
+* This file is part of EES2D.
+*
+*   EES2D is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   EES2D is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+*
+* ---------------------------------------------------------------------
+*
+* Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+*/
+
+#pragma once
+#include "mesh/Mesh.h"
+#include "solver/Scheduler.h"
+#include <atomic>
+#include <memory>
+#include <omp.h>
+#include <ostream>
+#include <vector>
+
+namespace ees2d::solver {
+
+	class StageTaskGraph {
+		// Dataflow schedule of one RK stage. Elements are split in contiguous partitions and the faces
+		// of each partition are split by kind (interior, wall, farfield...), each group being one flux task.
+		// A partition is updated as soon as every flux task touching one of its elements is done,
+		// without waiting for the rest of the mesh.
+		// run() must be called from inside a parallel region. Flux and update tasks are timed on the
+		// thread that runs them, the rest of the region is time spent waiting for tasks
+
+public:
+		StageTaskGraph(ees2d::mesh::Mesh &mesh, uint32_t partitionSize, uint32_t numThreads);
+
+		// flux(iface) is called for every face, update(begin, end) once per element partition
+		template<class FluxKernel, class UpdateKernel>
+		void run(const FluxKernel &flux, const UpdateKernel &update);
+
+		inline size_t numPartitions() const { return m_partitions.size() - 1; }
+		inline size_t numTasks() const { return m_taskFaceIndex.size() - 1; }
+
+		void report(std::ostream &) const;// Per-thread busy/idle time since last reset
+		inline RegionStats &stats() { return m_stats; }
+		inline const RegionStats &stats() const { return m_stats; }
+
+private:
+		std::vector<uint32_t> m_partitions;   // Element partition boundaries [0, p1, p2, ..., N_elems]
+		std::vector<uint32_t> m_taskFaceIndex;// Start of each flux task in m_taskFaces
+		std::vector<uint32_t> m_taskFaces;    // Faces of each flux task
+		std::vector<uint32_t> m_targetIndex;  // Start of each flux task in m_targets
+		std::vector<uint32_t> m_targets;      // Partitions whose elements are touched by each flux task
+		std::vector<uint32_t> m_pendingInit;  // Number of flux tasks each partition waits for
+		std::unique_ptr<std::atomic<uint32_t>[]> m_pending;
+		RegionStats m_stats;
+	};
+
+	//---------------------------------------------------------------
+	template<class FluxKernel, class UpdateKernel>
+	void StageTaskGraph::run(const FluxKernel &flux, const UpdateKernel &update) {
+		const double regionStart = omp_get_wtime();
+
+#pragma omp single
+		{
+			for (uint32_t partition = 0; partition < numPartitions(); partition++) {
+				m_pending[partition].store(m_pendingInit[partition], std::memory_order_relaxed);
+			}
+
+			for (uint32_t task = 0; task < numTasks(); task++) {
+#pragma omp task default(none) firstprivate(task) shared(flux, update)
+				{
+					const double fluxStart = omp_get_wtime();
+					for (uint32_t index = m_taskFaceIndex[task]; index < m_taskFaceIndex[task + 1]; index++) {
+						flux(m_taskFaces[index]);
+					}
+					m_stats.addBusy(omp_get_thread_num(), omp_get_wtime() - fluxStart);
+
+					// Release the partitions this task was the last dependency of
+					for (uint32_t index = m_targetIndex[task]; index < m_targetIndex[task + 1]; index++) {
+						const uint32_t partition = m_targets[index];
+						if (m_pending[partition].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+#pragma omp task default(none) firstprivate(partition) shared(update)
+							{
+								const double updateStart = omp_get_wtime();
+								update(m_partitions[partition], m_partitions[partition + 1]);
+								m_stats.addBusy(omp_get_thread_num(), omp_get_wtime() - updateStart);
+							}
+						}
+					}
+				}
+			}
+		}
+		// Every task is done at the barrier closing the single
+		m_stats.addRegion(omp_get_thread_num(), omp_get_wtime() - regionStart);
+	}
+
+}// namespace ees2d::solver
@@ -27,7 +27,15 @@ using namespace ees2d::solver;
 using namespace ees2d::mesh;
 
 void TimeIntegration::explicitEuler(Simulation &sim, Mesh &mesh) {
-	for (uint32_t elem = 0; elem < sim.dt.size(); elem++) {
+	explicitEuler(sim, mesh, 0, sim.dt.size());
+}
+// -------------------------------------
+void TimeIntegration::RK5(Simulation &sim, Mesh &mesh, const double &coeff,const std::vector<ConservativeVariables>& W0) {
+	RK5(sim, mesh, coeff, W0, 0, sim.dt.size());
+}
+// -------------------------------------
+void TimeIntegration::explicitEuler(Simulation &sim, Mesh &mesh, uint32_t begin, uint32_t end) {
+	for (uint32_t elem = begin; elem < end; elem++) {
 		// Updating conservative Variables
 		sim.conservativeVariables[elem].m_rho -= (sim.residuals[elem].m_rhoV_residual) * (sim.dt[elem]) / mesh.CvolumeArea(elem);
 		sim.conservativeVariables[elem].m_rho_u -= (sim.residuals[elem].m_rho_uV_residual) * (sim.dt[elem]) / mesh.CvolumeArea(elem);
@@ -36,10 +44,10 @@ void TimeIntegration::explicitEuler(Simulation &sim, Mesh &mesh) {
 	}
 }
 // -------------------------------------
-void TimeIntegration::RK5(Simulation &sim, Mesh &mesh, const double &coeff,const std::vector<ConservativeVariables>& W0) {
+void TimeIntegration::RK5(Simulation &sim, Mesh &mesh, const double &coeff, const std::vector<ConservativeVariables> &W0, uint32_t begin, uint32_t end) {
 
 
-	for (uint32_t elem = 0; elem < sim.dt.size(); elem++) {
+	for (uint32_t elem = begin; elem < end; elem++) {
 		double commonCoeff = sim.dt[elem] / mesh.CvolumeArea(elem);
 
 		double stageCoeff = coeff * commonCoeff;
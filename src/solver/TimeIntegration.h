@@ -28,4 +28,8 @@ namespace ees2d::solver::TimeIntegration {
 	void explicitEuler(ees2d::solver::Simulation& sim, ees2d::mesh::Mesh& mesh);
   void RK5(ees2d::solver::Simulation& sim, ees2d::mesh::Mesh& mesh, const double& coeff,const std::vector<ConservativeVariables>& W0);
 
+	// Same updates restricted to elements [begin, end)
+	void explicitEuler(ees2d::solver::Simulation& sim, ees2d::mesh::Mesh& mesh, uint32_t begin, uint32_t end);
+	void RK5(ees2d::solver::Simulation& sim, ees2d::mesh::Mesh& mesh, const double& coeff, const std::vector<ConservativeVariables>& W0, uint32_t begin, uint32_t end);
+
 }
\ No newline at end of file
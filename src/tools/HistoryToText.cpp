@@ -0,0 +1,68 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+// Text version of a binary convergence history (HISTORY_FILE) : one line per iteration, one column per value
+// Usage : EES2D_History history.bin [history.dat]    (standard output if no text file is given)
+
+#include "io/HistoryWriter.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using ees2d::io::HistoryWriter;
+
+
+int main(int argc, char *argv[]) {
+	if (argc < 2) {
+		std::cerr << "Usage : " << argv[0] << " history.bin [history.dat]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::vector<std::string> columns;
+	std::vector<std::vector<double>> rows;
+	if (!HistoryWriter::read(argv[1], columns, rows)) {
+		std::cerr << "Not a history file : " << argv[1] << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::ofstream fileStream;
+	if (argc > 2) {
+		fileStream.open(argv[2]);
+	}
+	std::ostream &os = argc > 2 ? fileStream : std::cout;
+
+	for (auto &column : columns) {
+		os << std::setw(24) << column;
+	}
+	os << "\n";
+
+	os << std::setprecision(15);
+	for (auto &row : rows) {
+		for (auto &value : row) {
+			os << std::setw(24) << value;
+		}
+		os << "\n";
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,368 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+// Synthetic SU2 meshes of any size, for scaling and I/O benchmarks. The same options give the same file.
+// Usage : EES2D_MeshGen ogrid|tri|mixed mesh.su2 [--option value ...]
+//   ogrid : quads around a NACA 4-digit airfoil, wall and farfield markers
+//           --naca 0012  --ni 256 (points around the airfoil)  --nj 128 (points to the farfield)
+//           --radius 50 (farfield distance in chords)  --stretch 1.05 (growth ratio of the radial spacing)
+//   tri   : triangulation of a rectangle with randomly moved nodes and diagonals, farfield marker
+//           --nx 100  --ny 100  --perturb 0.3 (node displacement, fraction of the spacing, at most 0.5)
+//   mixed : same rectangle, each cell is a quad or two triangles
+//           --nx 100  --ny 100  --perturb 0.3  --triangles 0.5 (fraction of cells split in triangles)
+//   every type : --cells N (approximate number of cells, sizes the grid instead of ni/nj or nx/ny)  --seed 1
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+
+namespace {
+
+	constexpr double pi = 3.14159265358979323846;
+
+	class Su2Stream {
+		// Buffered text output, the number conversions go through to_chars to keep 50M cell meshes fast
+public:
+		explicit Su2Stream(const std::string &path) : m_file(std::fopen(path.c_str(), "w")) { m_buffer.reserve(bufferSize + 256); }
+		~Su2Stream() {
+			if (m_file) {
+				flush();
+				std::fclose(m_file);
+			}
+		}
+
+		inline bool isOpen() const { return m_file != nullptr; }
+
+		Su2Stream &operator<<(const char *text) {
+			m_buffer += text;
+			return afterWrite();
+		}
+
+		Su2Stream &operator<<(uint64_t value) {
+			char digits[24];
+			m_buffer += ' ';
+			m_buffer.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+			return afterWrite();
+		}
+
+		Su2Stream &operator<<(double value) {
+			char digits[32];
+			m_buffer += ' ';
+			m_buffer.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);// Shortest exact representation
+			return afterWrite();
+		}
+
+private:
+		static constexpr size_t bufferSize = 1 << 20;
+
+		Su2Stream &afterWrite() {
+			if (m_buffer.size() >= bufferSize) {
+				flush();
+			}
+			return *this;
+		}
+
+		void flush() {
+			std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+			m_buffer.clear();
+		}
+
+		std::FILE *m_file;
+		std::string m_buffer;
+	};
+
+	//---------------------------------------------------------------
+	// Random number of item index, independent of the order the items are generated in (splitmix64)
+	double uniform(uint64_t seed, uint64_t index) {
+		uint64_t z = seed * 0x9E3779B97F4A7C15ull + index + 0x632BE59BD9B4E5F5ull;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		z = z ^ (z >> 31);
+		return (z >> 11) * (1.0 / 9007199254740992.0);// [0, 1)
+	}
+
+	//---------------------------------------------------------------
+	class Options {
+public:
+		Options(int argc, char *argv[], int first) {
+			for (int arg = first; arg + 1 < argc; arg += 2) {
+				std::string key = argv[arg];
+				if (key.rfind("--", 0) != 0) {
+					std::cerr << "Expected an option instead of : " << key << std::endl;
+					exit(EXIT_FAILURE);
+				}
+				m_values[key.substr(2)] = argv[arg + 1];
+			}
+			if ((argc - first) % 2 != 0) {
+				std::cerr << "Missing value of option : " << argv[argc - 1] << std::endl;
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		inline bool has(const std::string &key) const { return m_values.count(key) > 0; }
+		double number(const std::string &key, double defaultValue) const { return has(key) ? std::stod(m_values.at(key)) : defaultValue; }
+		std::string text(const std::string &key, const std::string &defaultValue) const { return has(key) ? m_values.at(key) : defaultValue; }
+
+private:
+		std::map<std::string, std::string> m_values;
+	};
+
+	//---------------------------------------------------------------
+	void writeHeader(Su2Stream &su2, uint64_t numElems) {
+		su2 << "%\n% Problem dimension\n%\nNDIME= 2\n%\n% Inner element connectivity\n%\nNELEM=" << numElems << "\n";
+	}
+
+	void writeNodesHeader(Su2Stream &su2, uint64_t numNodes) {
+		su2 << "%\n% Node coordinates\n%\nNPOIN=" << numNodes << "\n";
+	}
+
+	void writeMarker(Su2Stream &su2, const char *tag, const std::vector<std::pair<uint64_t, uint64_t>> &lines) {
+		su2 << "MARKER_TAG= " << tag << "\nMARKER_ELEMS=" << uint64_t(lines.size()) << "\n";
+		for (auto &[node1, node2] : lines) {
+			su2 << "3" << node1 << node2 << "\n";
+		}
+	}
+
+	//---------------------------------------------------------------
+	// Point of a NACA 4-digit airfoil (chord 1, closed trailing edge) at parameter s in [0, 2 pi) :
+	// s = 0 is the trailing edge, the upper surface comes first and s = pi is the leading edge
+	std::pair<double, double> nacaPoint(const std::string &digits, double s) {
+		const double m = (digits[0] - '0') / 100.0;
+		const double p = (digits[1] - '0') / 10.0;
+		const double t = std::stod(digits.substr(2, 2)) / 100.0;
+
+		const double x = 0.5 * (1 + std::cos(s));// Cosine spacing, points gather at both edges
+		const double yt = 5 * t * (0.2969 * std::sqrt(x) - 0.1260 * x - 0.3516 * x * x + 0.2843 * x * x * x - 0.1036 * x * x * x * x);
+
+		double yc = 0;
+		double slope = 0;
+		if (m > 0 && p > 0) {
+			if (x < p) {
+				yc = m / (p * p) * (2 * p * x - x * x);
+				slope = 2 * m / (p * p) * (p - x);
+			} else {
+				yc = m / ((1 - p) * (1 - p)) * (1 - 2 * p + 2 * p * x - x * x);
+				slope = 2 * m / ((1 - p) * (1 - p)) * (p - x);
+			}
+		}
+		const double theta = std::atan(slope);
+		const double side = s <= pi ? 1 : -1;
+		return {x - side * yt * std::sin(theta), yc + side * yt * std::cos(theta)};
+	}
+
+	void writeOGrid(const std::string &path, const Options &options) {
+		const std::string digits = options.text("naca", "0012");
+		if (digits.size() != 4 || digits.find_first_not_of("0123456789") != std::string::npos) {
+			std::cerr << "Not a NACA 4-digit airfoil : " << digits << std::endl;
+			exit(EXIT_FAILURE);
+		}
+
+		// Twice as many points around the airfoil as to the farfield when only the size is given
+		uint64_t nj = options.has("cells") ? uint64_t(std::sqrt(options.number("cells", 0) / 2)) + 1 : 128;
+		uint64_t ni = 2 * (nj - 1);
+		ni = options.number("ni", ni);
+		nj = options.number("nj", nj);
+		const double radius = options.number("radius", 50);
+		const double stretch = options.number("stretch", 1.05);
+		if (ni < 8 || nj < 2) {
+			std::cerr << "O-grid too small : ni >= 8 and nj >= 2" << std::endl;
+			exit(EXIT_FAILURE);
+		}
+
+		Su2Stream su2(path);
+		if (!su2.isOpen()) {
+			std::cerr << "Can't open " << path << std::endl;
+			exit(EXIT_FAILURE);
+		}
+
+		// Node (i, j) is i-th around the airfoil on the j-th ring, elements counterclockwise
+		auto node = [&](uint64_t i, uint64_t j) { return j * ni + i % ni; };
+
+		const uint64_t numElems = ni * (nj - 1);
+		writeHeader(su2, numElems);
+		for (uint64_t j = 0; j + 1 < nj; j++) {
+			for (uint64_t i = 0; i < ni; i++) {
+				su2 << "9" << node(i, j) << node(i, j + 1) << node(i + 1, j + 1) << node(i + 1, j) << j * ni + i << "\n";
+			}
+		}
+
+		// Grid lines leave the wall along its normal, so cells are not sheared where the surface is almost
+		// aligned with the radial direction (trailing edge), and turn radial towards the farfield
+		std::vector<double> xWall(ni), yWall(ni), normalAngle(ni);
+		for (uint64_t i = 0; i < ni; i++) {
+			std::tie(xWall[i], yWall[i]) = nacaPoint(digits, 2 * pi * i / ni);
+		}
+		for (uint64_t i = 0; i < ni; i++) {
+			const uint64_t previous = (i + ni - 1) % ni;
+			const uint64_t next = (i + 1) % ni;
+			const double s = 2 * pi * i / ni;
+			double angle = std::atan2(-(xWall[next] - xWall[previous]), yWall[next] - yWall[previous]);// Tangent turned clockwise
+			angle += 2 * pi * std::round((s - angle) / (2 * pi));                                       // Closest to s
+			normalAngle[i] = i == 0 ? angle : std::max(angle, normalAngle[i - 1]);                       // Lines must not cross
+		}
+
+		// Rings at distance r from the wall up to radius, r growing by stretch from one ring to the next
+		writeNodesHeader(su2, ni * nj);
+		const double total = stretch == 1 ? nj - 1 : (std::pow(stretch, nj - 1) - 1) / (stretch - 1);
+		for (uint64_t j = 0; j < nj; j++) {
+			const double f = (stretch == 1 ? j : (std::pow(stretch, j) - 1) / (stretch - 1)) / total;
+			for (uint64_t i = 0; i < ni; i++) {
+				const double s = 2 * pi * i / ni;
+				const double angle = normalAngle[i] + f * (s - normalAngle[i]);
+				su2 << xWall[i] + f * radius * std::cos(angle) << yWall[i] + f * radius * std::sin(angle) << node(i, j) << "\n";
+			}
+		}
+
+		std::vector<std::pair<uint64_t, uint64_t>> wall;
+		std::vector<std::pair<uint64_t, uint64_t>> farfield;
+		for (uint64_t i = 0; i < ni; i++) {
+			wall.push_back({node(i, 0), node(i + 1, 0)});
+			farfield.push_back({node(i, nj - 1), node(i + 1, nj - 1)});
+		}
+		su2 << "%\n% Boundary elements\n%\nNMARK= 2\n";
+		writeMarker(su2, "wall", wall);
+		writeMarker(su2, "farfield", farfield);
+
+		std::cout << std::setw(40) << "O-grid : " << ni << " x " << nj << " nodes, " << numElems << " quads\n";
+	}
+
+	//---------------------------------------------------------------
+	void writeRectangle(const std::string &path, const Options &options, bool mixed) {
+		const uint64_t seed = options.number("seed", 1);
+		const double perturb = options.number("perturb", 0.3);
+		const double triangles = mixed ? options.number("triangles", 0.5) : 1;
+		if (perturb < 0 || perturb > 0.5) {
+			std::cerr << "perturb must be in [0, 0.5] to keep every cell valid" << std::endl;
+			exit(EXIT_FAILURE);
+		}
+
+		// One cell gives 1 + triangles elements on average
+		uint64_t nx = options.has("cells") ? uint64_t(std::sqrt(options.number("cells", 0) / (1 + triangles))) : 100;
+		uint64_t ny = nx;
+		nx = std::max<uint64_t>(1, options.number("nx", nx));
+		ny = std::max<uint64_t>(1, options.number("ny", ny));
+
+		Su2Stream su2(path);
+		if (!su2.isOpen()) {
+			std::cerr << "Can't open " << path << std::endl;
+			exit(EXIT_FAILURE);
+		}
+
+		// Draws of each cell : split in triangles or not, direction of the diagonal
+		const uint64_t numCells = nx * ny;
+		auto split = [&](uint64_t cell) { return uniform(seed, 2 * cell) < triangles; };
+		auto risingDiagonal = [&](uint64_t cell) { return uniform(seed, 2 * cell + 1) < 0.5; };
+
+		uint64_t numTriangleCells = 0;
+		for (uint64_t cell = 0; cell < numCells; cell++) {
+			numTriangleCells += split(cell);
+		}
+		const uint64_t numElems = numCells + numTriangleCells;
+
+		auto node = [&](uint64_t i, uint64_t j) { return j * (nx + 1) + i; };
+
+		writeHeader(su2, numElems);
+		uint64_t elem = 0;
+		for (uint64_t j = 0; j < ny; j++) {
+			for (uint64_t i = 0; i < nx; i++) {
+				const uint64_t cell = j * nx + i;
+				const uint64_t a = node(i, j), b = node(i + 1, j), c = node(i + 1, j + 1), d = node(i, j + 1);
+				if (!split(cell)) {
+					su2 << "9" << a << b << c << d << elem++ << "\n";
+				} else if (risingDiagonal(cell)) {
+					su2 << "5" << a << b << c << elem++ << "\n";
+					su2 << "5" << a << c << d << elem++ << "\n";
+				} else {
+					su2 << "5" << a << b << d << elem++ << "\n";
+					su2 << "5" << b << c << d << elem++ << "\n";
+				}
+			}
+		}
+
+		// Square cells of side h, interior nodes moved by up to perturb * h / 2 in each direction
+		const double h = 1.0 / ny;
+		const uint64_t numNodes = (nx + 1) * (ny + 1);
+		writeNodesHeader(su2, numNodes);
+		for (uint64_t j = 0; j <= ny; j++) {
+			for (uint64_t i = 0; i <= nx; i++) {
+				const uint64_t index = node(i, j);
+				double x = i * h;
+				double y = j * h;
+				if (i > 0 && i < nx && j > 0 && j < ny) {
+					x += (uniform(seed + 1, 2 * index) - 0.5) * perturb * h;
+					y += (uniform(seed + 1, 2 * index + 1) - 0.5) * perturb * h;
+				}
+				su2 << x << y << index << "\n";
+			}
+		}
+
+		std::vector<std::pair<uint64_t, uint64_t>> farfield;
+		for (uint64_t i = 0; i < nx; i++) {
+			farfield.push_back({node(i, 0), node(i + 1, 0)});
+			farfield.push_back({node(i + 1, ny), node(i, ny)});
+		}
+		for (uint64_t j = 0; j < ny; j++) {
+			farfield.push_back({node(nx, j), node(nx, j + 1)});
+			farfield.push_back({node(0, j + 1), node(0, j)});
+		}
+		su2 << "%\n% Boundary elements\n%\nNMARK= 1\n";
+		writeMarker(su2, "farfield", farfield);
+
+		std::cout << std::setw(40) << (mixed ? "Mixed mesh : " : "Triangulation : ") << nx << " x " << ny << " cells, "
+		          << numCells - numTriangleCells << " quads, " << 2 * numTriangleCells << " triangles\n";
+	}
+
+}// namespace
+
+
+int main(int argc, char *argv[]) {
+	if (argc < 3) {
+		std::cerr << "Usage : " << argv[0] << " ogrid|tri|mixed mesh.su2 [--option value ...]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const std::string type = argv[1];
+	const std::string path = argv[2];
+	const Options options(argc, argv, 3);
+
+	if (type == "ogrid") {
+		writeOGrid(path, options);
+	} else if (type == "tri") {
+		writeRectangle(path, options, false);
+	} else if (type == "mixed") {
+		writeRectangle(path, options, true);
+	} else {
+		std::cerr << "Unknown mesh type : " << type << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
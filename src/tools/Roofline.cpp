@@ -0,0 +1,404 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+// Roofline of the solver kernels : flops and bytes moved per face or element for every kernel,
+// against the bandwidth and the flop rate this machine reaches, measured by built-in probes.
+// Usage : EES2D_Roofline control.ees2d [--option value ...]
+//   --mesh a.su2         mesh (default : MESH_FILE of the control file)
+//   --threads 4          threads of the probes and the kernels (default : OPEMMP_THREADS_NUM)
+//   --warmup 20          solver iterations run first, so the kernels see a developed flow
+//   --min-time 0.2       seconds every measurement runs at least
+//   --stream-mb 512      total size of the memory bandwidth probe arrays
+// Flops are counted from the source after common subexpressions : + - * / and sqrt count one each,
+// abs and comparisons none. Bytes are every array entry the kernel reads or writes, once (perfect
+// reuse inside a kernel, no write allocate), so the arithmetic intensity is an upper bound.
+// The bandwidth roof of a kernel is the STREAM triad measured on arrays of the kernel's working set,
+// so it is the cache level the kernel's data actually lives in. Far below a bandwidth roof points at
+// data layout (gathers, unused bytes in the cache lines), below the compute roof at the arithmetic
+// (divisions, square roots, no vectorization). Above 100 % the kernel reuses more than counted.
+
+#include "io/GmshParser.h"
+#include "io/InputParser.h"
+#include "io/Su2Parser.h"
+#include "mesh/Connectivity.h"
+#include "mesh/Mesh.h"
+#include "mesh/Metrics.h"
+#include "solver/BoundaryConditions.h"
+#include "solver/Schemes.h"
+#include "solver/Simulation.h"
+#include "solver/Solver.h"
+#include "solver/TimeIntegration.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <omp.h>
+#include <sstream>
+#include <tuple>
+#include <unistd.h>
+
+using ees2d::io::AbstractParser;
+using ees2d::io::InputParser;
+using ees2d::mesh::Connectivity;
+using ees2d::mesh::Mesh;
+using ees2d::mesh::MetricsData;
+using ees2d::solver::ConservativeVariables;
+using ees2d::solver::ConvectiveFlux;
+using ees2d::solver::Simulation;
+using ees2d::solver::Solver;
+
+
+namespace {
+
+	struct Kernel {
+		std::string name;
+		std::string unit;// face or elem
+		size_t items;
+		double flops;    // Per item
+		double bytes;    // Per item
+		std::function<void()> pass;// Every item once, opens its own parallel region
+
+		double seconds = 0;  // Per pass
+		double bandwidth = 0;// Triad GB/s on the kernel's working set
+	};
+
+	struct Bandwidth {
+		double copy = 0;// GB/s
+		double scale = 0;
+		double add = 0;
+		double triad = 0;
+	};
+
+	double seconds(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// Elements [begin, end) of the calling thread, static split
+	std::pair<uint32_t, uint32_t> threadRange(uint32_t items) {
+		const uint32_t threads = omp_get_num_threads();
+		const uint32_t thread = omp_get_thread_num();
+		return {uint32_t(uint64_t(items) * thread / threads), uint32_t(uint64_t(items) * (thread + 1) / threads)};
+	}
+
+	// Fastest pass of function, repeated for at least minTime seconds
+	double bestPass(const std::function<void()> &function, double minTime) {
+		function();// Warm the caches and the page tables
+		double best = 1e30;
+		const auto start = std::chrono::steady_clock::now();
+		do {
+			const auto passStart = std::chrono::steady_clock::now();
+			function();
+			best = std::min(best, seconds(passStart));
+		} while (seconds(start) < minTime);
+		return best;
+	}
+
+	size_t cacheSize(int name, size_t fallback) {
+		long size = -1;
+		if (name >= 0) {
+			size = sysconf(name);
+		}
+		return size > 0 ? size_t(size) : fallback;
+	}
+
+	//---------------------------------------------------------------
+	// STREAM kernels on three arrays of totalBytes / 24 doubles, first touched by the thread using them
+	Bandwidth streamProbe(size_t totalBytes, double minTime) {
+		const size_t n = std::max<size_t>(totalBytes / (3 * sizeof(double)), 1024);
+		std::unique_ptr<double[]> a(new double[n]);
+		std::unique_ptr<double[]> b(new double[n]);
+		std::unique_ptr<double[]> c(new double[n]);
+		const double scalar = 3.0;
+
+#pragma omp parallel for schedule(static)
+		for (size_t i = 0; i < n; i++) {
+			a[i] = 1.0;
+			b[i] = 2.0;
+			c[i] = 0.0;
+		}
+
+		const double bytes2 = 2 * sizeof(double) * double(n) / 1e9;
+		const double bytes3 = 3 * sizeof(double) * double(n) / 1e9;
+		Bandwidth bandwidth;
+		bandwidth.copy = bytes2 / bestPass([&] {
+#pragma omp parallel for schedule(static)
+			for (size_t i = 0; i < n; i++) { c[i] = a[i]; }
+		}, minTime / 4);
+		bandwidth.scale = bytes2 / bestPass([&] {
+#pragma omp parallel for schedule(static)
+			for (size_t i = 0; i < n; i++) { b[i] = scalar * c[i]; }
+		}, minTime / 4);
+		bandwidth.add = bytes3 / bestPass([&] {
+#pragma omp parallel for schedule(static)
+			for (size_t i = 0; i < n; i++) { c[i] = a[i] + b[i]; }
+		}, minTime / 4);
+		bandwidth.triad = bytes3 / bestPass([&] {
+#pragma omp parallel for schedule(static)
+			for (size_t i = 0; i < n; i++) { a[i] = b[i] + scalar * c[i]; }
+		}, minTime / 4);
+		return bandwidth;
+	}
+
+	//---------------------------------------------------------------
+	// Multiply-add chains held in registers, independent enough to fill the pipelines with the
+	// instructions this build targets (GFLOP/s)
+	double flopProbe(double minTime) {
+		constexpr uint32_t chains = 32;
+		constexpr uint64_t steps = 1 << 18;
+		volatile double factor = 0.999999;// Unknown to the compiler, so the chains can't be folded
+		volatile double increment = 1e-7;
+		volatile double sink = 0;
+
+		const double time = bestPass([&] {
+#pragma omp parallel
+			{
+				const double a = factor;
+				const double b = increment;
+				double x[chains];
+				for (uint32_t i = 0; i < chains; i++) {
+					x[i] = 1e-3 * i;
+				}
+				for (uint64_t step = 0; step < steps; step++) {
+					for (uint32_t i = 0; i < chains; i++) {
+						x[i] = x[i] * a + b;
+					}
+				}
+				double sum = 0;
+				for (uint32_t i = 0; i < chains; i++) {
+					sum += x[i];
+				}
+#pragma omp atomic
+				sink += sum;
+			}
+		}, minTime);
+
+		return 2.0 * chains * steps * omp_get_max_threads() / time / 1e9;
+	}
+
+	//---------------------------------------------------------------
+	std::unique_ptr<AbstractParser> parseMesh(const std::string &meshFile) {
+		std::unique_ptr<AbstractParser> parser;
+		if (meshFile.size() > 4 && meshFile.compare(meshFile.size() - 4, 4, ".msh") == 0) {
+			parser = std::make_unique<ees2d::io::GmshParser>(meshFile);
+		} else {
+			parser = std::make_unique<ees2d::io::Su2Parser>(meshFile);
+		}
+		parser->Parse();
+		return parser;
+	}
+
+}// namespace
+
+
+int main(int argc, char *argv[]) {
+	if (argc < 2 || argc % 2 != 0) {
+		std::cerr << "Usage : " << argv[0] << " control.ees2d [--mesh a.su2] [--threads 4] [--warmup 20] [--min-time 0.2] [--stream-mb 512]"
+		          << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::map<std::string, std::string> options = {{"warmup", "20"}, {"min-time", "0.2"}, {"stream-mb", "512"}};
+	for (int arg = 2; arg + 1 < argc; arg += 2) {
+		options[std::string(argv[arg]).substr(2)] = argv[arg + 1];
+	}
+
+	std::string controlFile = argv[1];
+	InputParser parameters{controlFile};
+	parameters.parse();
+	if (options.count("mesh")) {
+		parameters.m_meshFile = options["mesh"];
+	}
+	if (options.count("threads")) {
+		parameters.m_threads = std::stoul(options["threads"]);
+	}
+	parameters.m_maxIter = std::stoul(options["warmup"]);
+	parameters.m_minResiudal = 0;
+	parameters.m_outputResidual = "/dev/null";
+	parameters.m_historyFile.clear();
+	parameters.m_hardwareCounters = "FALSE";
+	parameters.m_loadBalanceReport = "FALSE";
+	const uint32_t threads = std::max(parameters.m_threads, 1u);
+	const double minTime = std::stod(options["min-time"]);
+	omp_set_num_threads(threads);
+
+	// Mesh, solver and a few iterations, with the logs dropped
+	std::ostringstream log;
+	std::streambuf *coutBuffer = std::cout.rdbuf(log.rdbuf());
+	std::unique_ptr<AbstractParser> parser = parseMesh(parameters.m_meshFile);
+	Connectivity connectivity(*parser);
+	connectivity.solve();
+	MetricsData metrics;
+	metrics.compute(connectivity);
+	Mesh mesh(connectivity, metrics);
+	Simulation sim(mesh, parameters);
+	Solver solver(sim, mesh);
+	if (parameters.m_maxIter > 0) {
+		solver.run();
+	}
+	std::cout.rdbuf(coutBuffer);
+
+	// Faces of each kind, with the element order of Solver::computeFaceFlux
+	std::vector<uint32_t> interiorFaces;
+	std::vector<uint32_t> wallFaces;
+	std::vector<uint32_t> farfieldFaces;
+	uint64_t elemFaces = 0;
+	for (uint32_t iface = 0; iface < mesh.N_faces; iface++) {
+		const uint32_t elem2 = std::max(mesh.FaceToElem(iface, 0), mesh.FaceToElem(iface, 1));
+		if (elem2 < mesh.N_elems) {
+			interiorFaces.push_back(iface);
+		} else if (elem2 == uint32_t(-1)) {
+			wallFaces.push_back(iface);
+		} else if (elem2 == uint32_t(-3)) {
+			farfieldFaces.push_back(iface);
+		}
+	}
+	for (uint32_t ielem = 0; ielem < mesh.N_elems; ielem++) {
+		elemFaces += mesh.NbOfNodesSurroundingElem(ielem);
+	}
+	const double facesPerElem = double(elemFaces) / std::max<size_t>(mesh.N_elems, 1);
+
+	std::vector<ConvectiveFlux> fluxes(mesh.N_faces);// Output of the face kernels
+	const std::vector<ConservativeVariables> W0 = sim.conservativeVariables;
+
+	auto facePass = [&](const std::vector<uint32_t> &faces, const std::function<ConvectiveFlux(uint32_t, uint32_t, uint32_t, Solver::faceParams &)> &kernel) {
+		return [&faces, &fluxes, &mesh, kernel] {
+#pragma omp parallel for schedule(static)
+			for (size_t index = 0; index < faces.size(); index++) {
+				const uint32_t iface = faces[index];
+				const uint32_t elem1 = std::min(mesh.FaceToElem(iface, 0), mesh.FaceToElem(iface, 1));
+				const uint32_t elem2 = std::max(mesh.FaceToElem(iface, 0), mesh.FaceToElem(iface, 1));
+				Solver::faceParams faceP;
+				fluxes[iface] = kernel(iface, elem1, elem2, faceP);
+			}
+		};
+	};
+	auto elemPass = [&](const std::function<void(uint32_t, uint32_t)> &kernel) {
+		return [&mesh, kernel] {
+#pragma omp parallel
+			{
+				const auto [begin, end] = threadRange(mesh.N_elems);
+				kernel(begin, end);
+			}
+		};
+	};
+
+	// Face kernels : inner element's rho, u, v, p, H (40) or both elements' (80), face elements (8),
+	// face vector and area (24), flux written (32). Element kernels : see each line
+	std::vector<Kernel> kernels = {
+	        {"Roe (interior)", "face", interiorFaces.size(), 140, 144, facePass(interiorFaces, [&](uint32_t iface, uint32_t elem1, uint32_t elem2, Solver::faceParams &faceP) {
+		         return ees2d::solver::scheme::RoeScheme(elem1, elem2, iface, faceP, sim, mesh);
+	         })},
+	        {"BC wall", "face", wallFaces.size(), 9, 104, facePass(wallFaces, [&](uint32_t iface, uint32_t elem1, uint32_t, Solver::faceParams &faceP) {
+		         return ees2d::solver::BC::wall(elem1, iface, faceP, sim, mesh);
+	         })},
+	        {"BC supersonic inflow", "face", farfieldFaces.size(), 24, 64, facePass(farfieldFaces, [&](uint32_t iface, uint32_t, uint32_t, Solver::faceParams &faceP) {
+		         return ees2d::solver::BC::farfieldSupersonicInflow(iface, faceP, sim, mesh);// Freestream only : no element read
+	         })},
+	        {"BC supersonic outflow", "face", farfieldFaces.size(), 24, 104, facePass(farfieldFaces, [&](uint32_t iface, uint32_t elem1, uint32_t, Solver::faceParams &faceP) {
+		         return ees2d::solver::BC::farfieldSupersonicOutflow(elem1, iface, faceP, sim, mesh);
+	         })},
+	        {"BC subsonic inflow", "face", farfieldFaces.size(), 48, 104, facePass(farfieldFaces, [&](uint32_t iface, uint32_t elem1, uint32_t, Solver::faceParams &faceP) {
+		         return ees2d::solver::BC::farfieldSubsonicInflow(elem1, iface, faceP, sim, mesh);
+	         })},
+	        {"BC subsonic outflow", "face", farfieldFaces.size(), 39, 104, facePass(farfieldFaces, [&](uint32_t iface, uint32_t elem1, uint32_t, Solver::faceParams &faceP) {
+		         return ees2d::solver::BC::farfieldSubsonicOutflow(elem1, iface, faceP, sim, mesh);
+	         })},
+	        // Per face of the element : face ID (4), face elements (8), flux (32), area (8), spectral radius (8),
+	        // 4 multiplies and 5 adds. Row start (4), residual and spectral radius written (40)
+	        {"residual gather", "elem", mesh.N_elems, 9 * facesPerElem, 60 * facesPerElem + 44, elemPass([&](uint32_t begin, uint32_t end) {
+		         solver.updateResidual(begin, end);
+	         })},
+	        // Area and spectral radius read (16), dt written (8)
+	        {"local time step", "elem", mesh.N_elems, 2, 24, elemPass([&](uint32_t begin, uint32_t end) {
+		         double courantNumber = sim.cfl;
+		         solver.updateLocalTimeSteps(courantNumber, begin, end);
+	         })},
+	        // W0, residual, dt and area read (80), W written (32)
+	        {"RK5 stage", "elem", mesh.N_elems, 10, 112, elemPass([&](uint32_t begin, uint32_t end) {
+		         ees2d::solver::TimeIntegration::RK5(sim, mesh, 0.0533, W0, begin, end);
+	         })},
+	        // W read (32), rho, u, v, E, p, H and Mach written (56)
+	        {"primitive variables", "elem", mesh.N_elems, 17, 88, elemPass([&](uint32_t begin, uint32_t end) {
+		         solver.updateVariables(begin, end);
+	         })},
+	        // Residual read (32)
+	        {"residual RMS", "elem", mesh.N_elems, 8, 32, [&] {
+		         Solver::ResidualRMS rms(1, 1, 1, 1);
+#pragma omp parallel
+		         solver.findRms(rms);
+	         }},
+	};
+
+	// Machine : memory and L2 bandwidth, flop rate
+	const size_t l2Size = cacheSize(
+#ifdef _SC_LEVEL2_CACHE_SIZE
+	        _SC_LEVEL2_CACHE_SIZE,
+#else
+	        -1,
+#endif
+	        256 * 1024);
+	const size_t memoryBytes = std::stoul(options["stream-mb"]) << 20;
+	const size_t l2Bytes = threads * l2Size / 2;// Half of the L2 of every thread
+	const Bandwidth memory = streamProbe(memoryBytes, minTime);
+	const Bandwidth l2 = streamProbe(l2Bytes, minTime);
+	const double peak = flopProbe(minTime);
+
+	std::cout << std::setprecision(4);
+	std::cout << "[ roofline ] " << parameters.m_meshFile << " : " << mesh.N_elems << " cells, " << mesh.N_faces << " faces, " << threads
+	          << " threads\n";
+	std::cout << std::setw(24) << "probe" << std::setw(12) << "size (MB)" << std::setw(12) << "copy" << std::setw(12) << "scale"
+	          << std::setw(12) << "add" << std::setw(12) << "triad" << "   GB/s\n";
+	for (auto &[name, size, bandwidth] : {std::tuple<std::string, size_t, Bandwidth>{"memory", memoryBytes, memory}, {"L2", l2Bytes, l2}}) {
+		std::cout << std::setw(24) << name << std::setw(12) << size / double(1 << 20) << std::setw(12) << bandwidth.copy << std::setw(12)
+		          << bandwidth.scale << std::setw(12) << bandwidth.add << std::setw(12) << bandwidth.triad << "\n";
+	}
+	std::cout << std::setw(24) << "peak multiply-add" << std::setw(12) << "" << std::setw(12) << peak << " GFLOP/s\n";
+	std::cout << std::setw(24) << "ridge point" << std::setw(12) << "" << std::setw(12) << peak / memory.triad << " flop/B (memory), "
+	          << peak / l2.triad << " flop/B (L2)\n\n";
+
+	std::cout << std::setw(24) << "kernel" << std::setw(9) << "items" << std::setw(10) << "flop/item" << std::setw(10) << "B/item"
+	          << std::setw(10) << "flop/B" << std::setw(10) << "ns/item" << std::setw(10) << "GFLOP/s" << std::setw(10) << "GB/s"
+	          << std::setw(11) << "roof GB/s" << std::setw(10) << "bound" << std::setw(10) << "% roof" << "  limited by\n";
+	for (auto &kernel : kernels) {
+		if (kernel.items == 0) {
+			std::cout << std::setw(24) << kernel.name << std::setw(9) << 0 << "  no " << kernel.unit << " of this kind in the mesh\n";
+			continue;
+		}
+		kernel.seconds = bestPass(kernel.pass, minTime);
+		kernel.bandwidth = streamProbe(size_t(kernel.bytes * kernel.items), minTime / 2).triad;
+
+		const double intensity = kernel.flops / kernel.bytes;
+		const double gflops = kernel.flops * kernel.items / kernel.seconds / 1e9;
+		const double gbytes = kernel.bytes * kernel.items / kernel.seconds / 1e9;
+		const double bound = std::min(peak, intensity * kernel.bandwidth);
+		std::cout << std::setw(24) << kernel.name << std::setw(9) << kernel.items << std::setw(10) << kernel.flops << std::setw(10)
+		          << kernel.bytes << std::setw(10) << intensity << std::setw(10) << 1e9 * kernel.seconds / kernel.items << std::setw(10)
+		          << gflops << std::setw(10) << gbytes << std::setw(11) << kernel.bandwidth << std::setw(10) << bound
+		          << std::setw(10) << 100 * gflops / bound << "  " << (intensity * kernel.bandwidth < peak ? "bandwidth" : "compute") << "\n";
+	}
+	return EXIT_SUCCESS;
+}
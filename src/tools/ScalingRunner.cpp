@@ -0,0 +1,267 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+// Strong and weak scaling of the solver : every mesh is preprocessed and solved for a fixed number of
+// iterations with every thread count, the timings go to a CSV and a JSON report.
+// Usage : EES2D_Scaling control.ees2d --meshes a.su2,b.msh [--option value ...]
+//   --threads 1,2,4,8    thread counts (default : powers of two up to the hardware threads)
+//   --iterations 50      iterations per run, the residual criterion is ignored
+//   --repeat 1           runs of each case, the fastest one is kept
+//   --mode strong        strong : every mesh with every thread count
+//                        weak   : i-th mesh with the i-th thread count (meshes growing with the threads)
+//   --csv scaling.csv  --json scaling.json
+// Freestream, scheme and schedule come from the control file. Meshes of any size come from EES2D_MeshGen.
+// Efficiency is the throughput per thread (cells * iterations / s / threads) relative to the first run
+// of the same mesh (strong) or to the first run (weak).
+
+#include "io/GmshParser.h"
+#include "io/InputParser.h"
+#include "io/Su2Parser.h"
+#include "mesh/Connectivity.h"
+#include "mesh/Mesh.h"
+#include "mesh/Metrics.h"
+#include "solver/Simulation.h"
+#include "solver/Solver.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <omp.h>
+#include <sstream>
+#include <thread>
+
+using ees2d::io::AbstractParser;
+using ees2d::io::InputParser;
+using ees2d::mesh::Connectivity;
+using ees2d::mesh::Mesh;
+using ees2d::mesh::MetricsData;
+using ees2d::solver::Simulation;
+using ees2d::solver::Solver;
+
+
+namespace {
+
+	struct Run {
+		std::string mesh;
+		uint64_t cells = 0;
+		uint64_t faces = 0;
+		uint32_t threads = 0;
+		uint32_t iterations = 0;
+		double preprocessing = 0;// s
+		double solver = 0;       // s
+		double efficiency = 0;
+
+		inline double timePerIteration() const { return solver / iterations; }
+		inline double cellIterationsPerSecond() const { return cells * double(iterations) / solver; }
+	};
+
+	double seconds(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	std::vector<std::string> split(const std::string &list) {
+		std::vector<std::string> items;
+		std::stringstream ss(list);
+		std::string item;
+		while (std::getline(ss, item, ',')) {
+			if (!item.empty()) {
+				items.push_back(item);
+			}
+		}
+		return items;
+	}
+
+	//---------------------------------------------------------------
+	// Preprocessing and solver of one mesh with one thread count, the solver logs are dropped
+	Run runCase(InputParser parameters, const std::string &meshFile, uint32_t threads, uint32_t iterations) {
+		parameters.m_meshFile = meshFile;
+		parameters.m_threads = threads;
+		parameters.m_maxIter = iterations;
+		parameters.m_minResiudal = 0;
+		parameters.m_outputResidual = "/dev/null";
+		parameters.m_historyFile.clear();
+		parameters.m_hardwareCounters = "FALSE";
+		parameters.m_loadBalanceReport = "FALSE";
+		omp_set_num_threads(threads);
+
+		std::ostringstream log;
+		std::streambuf *coutBuffer = std::cout.rdbuf(log.rdbuf());
+
+		Run run;
+		run.mesh = meshFile;
+		run.threads = threads;
+
+		auto start = std::chrono::steady_clock::now();
+		std::unique_ptr<AbstractParser> parser;
+		if (meshFile.size() > 4 && meshFile.compare(meshFile.size() - 4, 4, ".msh") == 0) {
+			parser = std::make_unique<ees2d::io::GmshParser>(meshFile);
+		} else {
+			parser = std::make_unique<ees2d::io::Su2Parser>(meshFile);
+		}
+		parser->Parse();
+		Connectivity connectivity(*parser);
+		connectivity.solve();
+		MetricsData metrics;
+		metrics.compute(connectivity);
+		run.preprocessing = seconds(start);
+
+		Mesh mesh(connectivity, metrics);
+		Simulation sim(mesh, parameters);
+		Solver solver(sim, mesh);
+		solver.setIterationCallback([&](uint32_t iteration) { run.iterations = iteration; });
+
+		start = std::chrono::steady_clock::now();
+		solver.run();
+		run.solver = seconds(start);
+
+		std::cout.rdbuf(coutBuffer);
+
+		run.cells = mesh.N_elems;
+		run.faces = mesh.N_faces;
+		if (run.iterations < iterations) {
+			std::cerr << "Warning : " << meshFile << " with " << threads << " threads stopped after " << run.iterations << " iterations" << std::endl;
+		}
+		run.iterations = std::max(run.iterations, 1u);
+		return run;
+	}
+
+	//---------------------------------------------------------------
+	void writeCsv(const std::string &path, const std::vector<Run> &runs) {
+		std::ofstream csv(path);
+		csv << "mesh,cells,faces,threads,iterations,preprocessing_s,solver_s,time_per_iteration_s,cell_iterations_per_s,efficiency\n";
+		csv << std::setprecision(9);
+		for (auto &run : runs) {
+			csv << run.mesh << "," << run.cells << "," << run.faces << "," << run.threads << "," << run.iterations << ","
+			    << run.preprocessing << "," << run.solver << "," << run.timePerIteration() << "," << run.cellIterationsPerSecond() << ","
+			    << run.efficiency << "\n";
+		}
+	}
+
+	void writeJson(const std::string &path, const std::string &mode, const std::vector<Run> &runs) {
+		std::ofstream json(path);
+		json << std::setprecision(9);
+		json << "{\n  \"mode\": \"" << mode << "\",\n  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n  \"runs\": [\n";
+		for (size_t index = 0; index < runs.size(); index++) {
+			const Run &run = runs[index];
+			json << "    {\"mesh\": \"" << run.mesh << "\", \"cells\": " << run.cells << ", \"faces\": " << run.faces
+			     << ", \"threads\": " << run.threads << ", \"iterations\": " << run.iterations
+			     << ", \"preprocessing_s\": " << run.preprocessing << ", \"solver_s\": " << run.solver
+			     << ", \"time_per_iteration_s\": " << run.timePerIteration() << ", \"cell_iterations_per_s\": " << run.cellIterationsPerSecond()
+			     << ", \"efficiency\": " << run.efficiency << "}" << (index + 1 < runs.size() ? "," : "") << "\n";
+		}
+		json << "  ]\n}\n";
+	}
+
+}// namespace
+
+
+int main(int argc, char *argv[]) {
+	if (argc < 4 || (argc - 2) % 2 != 0) {
+		std::cerr << "Usage : " << argv[0] << " control.ees2d --meshes a.su2,b.su2 [--threads 1,2,4] [--iterations 50] [--repeat 1]"
+		          << " [--mode strong|weak] [--csv scaling.csv] [--json scaling.json]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::map<std::string, std::string> options = {{"iterations", "50"}, {"repeat", "1"}, {"mode", "strong"}, {"csv", "scaling.csv"}, {"json", "scaling.json"}};
+	for (int arg = 2; arg + 1 < argc; arg += 2) {
+		options[std::string(argv[arg]).substr(2)] = argv[arg + 1];
+	}
+
+	std::vector<uint32_t> threadCounts;
+	if (options.count("threads")) {
+		for (auto &count : split(options["threads"])) {
+			threadCounts.push_back(std::stoul(count));
+		}
+	} else {
+		for (uint32_t count = 1; count <= std::max(1u, std::thread::hardware_concurrency()); count *= 2) {
+			threadCounts.push_back(count);
+		}
+	}
+	const std::vector<std::string> meshes = split(options["meshes"]);
+	const uint32_t iterations = std::stoul(options["iterations"]);
+	const uint32_t repeat = std::max(1ul, std::stoul(options["repeat"]));
+	const std::string mode = options["mode"];
+
+	if (meshes.empty() || threadCounts.empty() || (mode != "strong" && mode != "weak")) {
+		std::cerr << "Give at least one mesh and one thread count, mode is strong or weak" << std::endl;
+		return EXIT_FAILURE;
+	}
+	if (mode == "weak" && meshes.size() != threadCounts.size()) {
+		std::cerr << "Weak scaling pairs the meshes with the thread counts : " << meshes.size() << " meshes for "
+		          << threadCounts.size() << " thread counts" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::string controlFile = argv[1];
+	InputParser parameters{controlFile};
+	parameters.parse();
+
+	// Cases in run order : (mesh, threads)
+	std::vector<std::pair<std::string, uint32_t>> cases;
+	for (size_t index = 0; index < meshes.size(); index++) {
+		if (mode == "weak") {
+			cases.push_back({meshes[index], threadCounts[index]});
+		} else {
+			for (auto &threads : threadCounts) {
+				cases.push_back({meshes[index], threads});
+			}
+		}
+	}
+
+	std::vector<Run> runs;
+	std::cout << std::setw(40) << "mesh" << std::setw(10) << "cells" << std::setw(9) << "threads" << std::setw(18) << "preprocessing (s)"
+	          << std::setw(16) << "iteration (ms)" << std::setw(16) << "cells*it/s" << std::setw(12) << "efficiency" << "\n";
+	for (auto &[mesh, threads] : cases) {
+		Run best;
+		for (uint32_t attempt = 0; attempt < repeat; attempt++) {
+			Run run = runCase(parameters, mesh, threads, iterations);
+			if (attempt == 0 || run.timePerIteration() < best.timePerIteration()) {
+				best = run;
+			}
+		}
+
+		// Baseline : first run of this mesh (strong) or first run (weak)
+		const Run *baseline = &best;
+		for (auto &run : runs) {
+			if (mode == "weak" || run.mesh == best.mesh) {
+				baseline = &run;
+				break;
+			}
+		}
+		best.efficiency = (best.cellIterationsPerSecond() / best.threads) / (baseline->cellIterationsPerSecond() / baseline->threads);
+		runs.push_back(best);
+
+		std::cout << std::setw(40) << best.mesh << std::setw(10) << best.cells << std::setw(9) << best.threads << std::setw(18) << best.preprocessing
+		          << std::setw(16) << 1e3 * best.timePerIteration() << std::setw(16) << best.cellIterationsPerSecond() << std::setw(12)
+		          << best.efficiency << std::endl;
+	}
+
+	writeCsv(options["csv"], runs);
+	writeJson(options["json"], mode, runs);
+	std::cout << std::setw(40) << "Scaling report : " << options["csv"] << ", " << options["json"] << "\n";
+	return EXIT_SUCCESS;
+}
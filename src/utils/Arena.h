@@ -0,0 +1,119 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+
+namespace ees2d::utils {
+
+	class Arena {
+		// Monotonic allocator for scratch arrays: memory is carved out of large blocks and only
+		// given back all at once, instead of one heap call per array. reset() keeps the blocks for
+		// the next round of allocations, release() and the destructor free them.
+		// Every allocation is aligned on a cache line so per-thread slices don't share lines.
+		// Not thread safe : allocate before entering a parallel region and hand out slices
+public:
+		explicit Arena(size_t blockSize = 1 << 20) : m_blockSize(blockSize) {}
+
+		Arena(const Arena &) = delete;
+		Arena &operator=(const Arena &) = delete;
+
+		// Uninitialized array of count T
+		template<class T>
+		T *allocate(size_t count) {
+			static_assert(std::is_trivially_destructible_v<T>, "Arena memory is never destroyed element-wise");
+			return reinterpret_cast<T *>(allocateBytes(count * sizeof(T)));
+		}
+
+		// Array of count T filled with value
+		template<class T>
+		T *allocate(size_t count, const T &value) {
+			T *data = allocate<T>(count);
+			std::fill(data, data + count, value);
+			return data;
+		}
+
+		// Make every block available again, previously returned pointers become invalid
+		void reset() {
+			m_current = 0;
+			m_offset = 0;
+		}
+
+		// Free every block, previously returned pointers become invalid
+		void release() {
+			m_blocks.clear();
+			m_blocks.shrink_to_fit();
+			reset();
+		}
+
+		inline size_t capacity() const {
+			size_t bytes = 0;
+			for (auto &block : m_blocks) {
+				bytes += block.size;
+			}
+			return bytes;
+		}
+
+private:
+		static constexpr size_t alignment = 64;
+
+		struct Block {
+			std::unique_ptr<std::byte[]> data;
+			size_t size;
+		};
+
+		std::byte *allocateBytes(size_t bytes) {
+			bytes = std::max<size_t>((bytes + alignment - 1) / alignment * alignment, alignment);
+
+			// Move to the next block that fits, or append a new one
+			while (m_current < m_blocks.size() && m_offset + bytes > m_blocks[m_current].size) {
+				m_current++;
+				m_offset = 0;
+			}
+			if (m_current == m_blocks.size()) {
+				const size_t size = std::max(bytes, m_blockSize);
+				m_blocks.push_back({std::unique_ptr<std::byte[]>(new std::byte[size + alignment]), size});// Left uninitialized
+				m_offset = 0;
+			}
+
+			std::byte *base = m_blocks[m_current].data.get();
+			const size_t shift = (alignment - reinterpret_cast<uintptr_t>(base) % alignment) % alignment;
+			std::byte *ptr = base + shift + m_offset;
+			m_offset += bytes;
+			return ptr;
+		}
+
+		size_t m_blockSize;
+		size_t m_current = 0;// Block currently allocated from
+		size_t m_offset = 0; // First free byte of the current block (past the alignment shift)
+		std::vector<Block> m_blocks;
+	};
+
+}// namespace ees2d::utils
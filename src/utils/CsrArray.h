@@ -0,0 +1,206 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace ees2d::utils {
+
+	template<class T>
+	class CsrArray {
+		// Rows of variable length stored back to back in one array (compressed sparse row)
+		// Row i is data()[index()[i]] ... data()[index()[i + 1] - 1]
+		// The array owns its values, or is a read-only view of values owned by someone else (a mapped cache file)
+		// that must outlive it. The non-const accessors can't be used on a view
+public:
+		CsrArray() : m_ownIndex(1, 0) { bind(); }
+		CsrArray(const CsrArray &other) : m_ownIndex(other.m_ownIndex), m_ownData(other.m_ownData) { copyBinding(other); }
+		CsrArray(CsrArray &&other) noexcept : m_ownIndex(std::move(other.m_ownIndex)), m_ownData(std::move(other.m_ownData)) {
+			copyBinding(other);
+			other.m_ownIndex.assign(1, 0);
+			other.bind();
+		}
+		CsrArray &operator=(CsrArray other) noexcept {
+			m_ownIndex.swap(other.m_ownIndex);
+			m_ownData.swap(other.m_ownData);
+			copyBinding(other);
+			return *this;
+		}
+
+		// Allocate rows of the given sizes, values are left to the caller
+		template<class SizeContainer>
+		void assignRowSizes(const SizeContainer &rowSizes) {
+			m_ownIndex.resize(rowSizes.size() + 1);
+			m_ownIndex[0] = 0;
+			for (size_t row = 0; row < rowSizes.size(); row++) {
+				m_ownIndex[row + 1] = m_ownIndex[row] + rowSizes[row];
+			}
+			m_ownData.assign(m_ownIndex.back(), T());
+			bind();
+		}
+
+		// Take over existing row offsets (rows + 1 entries) and values
+		void assign(std::vector<uint32_t> &&index, std::vector<T> &&data) {
+			m_ownIndex = std::move(index);
+			m_ownData = std::move(data);
+			bind();
+		}
+
+		// Use rows + 1 offsets and their values in place, without copying them
+		void view(const uint32_t *index, size_t rows, const T *data) {
+			m_ownIndex.clear();
+			m_ownData.clear();
+			m_index = const_cast<uint32_t *>(index);
+			m_data = const_cast<T *>(data);
+			m_rows = rows;
+			m_view = true;
+		}
+
+		inline bool isView() const { return m_view; }
+
+		inline size_t size() const { return m_rows; }// Number of rows
+		inline size_t rowSize(const size_t &row) const { return m_index[row + 1] - m_index[row]; }
+
+		inline T &operator()(const size_t &row, const size_t &col) { return m_data[m_index[row] + col]; }
+		inline const T &operator()(const size_t &row, const size_t &col) const { return m_data[m_index[row] + col]; }
+
+		inline T *row(const size_t &row) { return m_data + m_index[row]; }
+		inline const T *row(const size_t &row) const { return m_data + m_index[row]; }
+
+		inline const uint32_t *index() const { return m_index; }
+		inline size_t indexSize() const { return m_rows + 1; }
+		inline const T *data() const { return m_data; }
+		inline size_t dataSize() const { return m_index[m_rows]; }
+
+private:
+		void bind() {
+			m_index = m_ownIndex.data();
+			m_data = m_ownData.data();
+			m_rows = m_ownIndex.size() - 1;
+			m_view = false;
+		}
+
+		void copyBinding(const CsrArray &other) {
+			if (other.m_view) {
+				m_index = other.m_index;
+				m_data = other.m_data;
+				m_rows = other.m_rows;
+				m_view = true;
+			} else {
+				bind();
+			}
+		}
+
+		std::vector<uint32_t> m_ownIndex;// Storage of an owning array, empty for a view
+		std::vector<T> m_ownData;
+		uint32_t *m_index = nullptr;     // Offsets and values in use : the storage above or the viewed memory
+		T *m_data = nullptr;
+		size_t m_rows = 0;
+		bool m_view = false;
+	};
+
+	//---------------------------------------------------------------
+
+	template<class T, size_t Stride>
+	class StridedArray {
+		// Rows of Stride values stored back to back in one array
+		// Row i is data()[Stride * i] ... data()[Stride * i + Stride - 1]
+		// Owning or read-only view, like CsrArray
+public:
+		StridedArray() = default;
+		StridedArray(const StridedArray &other) : m_own(other.m_own) { copyBinding(other); }
+		StridedArray(StridedArray &&other) noexcept : m_own(std::move(other.m_own)) {
+			copyBinding(other);
+			other.m_own.clear();
+			other.bind();
+		}
+		StridedArray &operator=(StridedArray other) noexcept {
+			m_own.swap(other.m_own);
+			copyBinding(other);
+			return *this;
+		}
+
+		inline void resize(const size_t &rows) {
+			m_own.resize(Stride * rows);
+			bind();
+		}
+		inline void assign(const size_t &rows, const T &value) {
+			m_own.assign(Stride * rows, value);
+			bind();
+		}
+		inline void assign(std::vector<T> &&data) {// Stride values per row
+			m_own = std::move(data);
+			bind();
+		}
+
+		// Use the Stride * rows values in place, without copying them
+		void view(const T *data, size_t rows) {
+			m_own.clear();
+			m_data = const_cast<T *>(data);
+			m_rows = rows;
+			m_view = true;
+		}
+
+		inline bool isView() const { return m_view; }
+
+		inline size_t size() const { return m_rows; }// Number of rows
+		static constexpr size_t rowSize(const size_t & = 0) { return Stride; }
+
+		inline T &operator()(const size_t &row, const size_t &col) { return m_data[Stride * row + col]; }
+		inline const T &operator()(const size_t &row, const size_t &col) const { return m_data[Stride * row + col]; }
+
+		inline T *row(const size_t &row) { return m_data + Stride * row; }
+		inline const T *row(const size_t &row) const { return m_data + Stride * row; }
+
+		inline const T *data() const { return m_data; }
+		inline size_t dataSize() const { return Stride * m_rows; }
+
+private:
+		void bind() {
+			m_data = m_own.data();
+			m_rows = m_own.size() / Stride;
+			m_view = false;
+		}
+
+		void copyBinding(const StridedArray &other) {
+			if (other.m_view) {
+				m_data = other.m_data;
+				m_rows = other.m_rows;
+				m_view = true;
+			} else {
+				bind();
+			}
+		}
+
+		std::vector<T> m_own;// Storage of an owning array, empty for a view
+		T *m_data = nullptr;
+		size_t m_rows = 0;
+		bool m_view = false;
+	};
+
+}// namespace ees2d::utils
@@ -0,0 +1,95 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+// Replacement of the global allocation functions, so the heap counters of MemoryReport see every
+// allocation of the process. Only compiled into EES2D_App : the tests and benchmarks keep the
+// allocator of the standard library
+#include "MemoryReport.h"
+#include <cstdlib>
+#include <new>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using ees2d::utils::MemoryReport;
+
+
+namespace {
+
+	size_t usableSize(void *ptr) {
+#ifdef __GLIBC__
+		return malloc_usable_size(ptr);
+#else
+		(void) ptr;
+		return 0;
+#endif
+	}
+
+	void *allocate(size_t bytes, size_t alignment, bool nothrow) {
+		void *ptr = nullptr;
+		if (alignment <= alignof(std::max_align_t)) {
+			ptr = std::malloc(bytes > 0 ? bytes : 1);
+		} else if (posix_memalign(&ptr, alignment, bytes > 0 ? bytes : 1) != 0) {
+			ptr = nullptr;
+		}
+		if (ptr == nullptr) {
+			if (nothrow) {
+				return nullptr;
+			}
+			throw std::bad_alloc();
+		}
+		MemoryReport::countAllocation(usableSize(ptr));
+		return ptr;
+	}
+
+	void deallocate(void *ptr) {
+		if (ptr != nullptr) {
+			MemoryReport::countDeallocation(usableSize(ptr));
+			std::free(ptr);
+		}
+	}
+
+}// namespace
+
+void *operator new(size_t bytes) { return allocate(bytes, 0, false); }
+void *operator new[](size_t bytes) { return allocate(bytes, 0, false); }
+void *operator new(size_t bytes, const std::nothrow_t &) noexcept { return allocate(bytes, 0, true); }
+void *operator new[](size_t bytes, const std::nothrow_t &) noexcept { return allocate(bytes, 0, true); }
+void *operator new(size_t bytes, std::align_val_t alignment) { return allocate(bytes, size_t(alignment), false); }
+void *operator new[](size_t bytes, std::align_val_t alignment) { return allocate(bytes, size_t(alignment), false); }
+void *operator new(size_t bytes, std::align_val_t alignment, const std::nothrow_t &) noexcept { return allocate(bytes, size_t(alignment), true); }
+void *operator new[](size_t bytes, std::align_val_t alignment, const std::nothrow_t &) noexcept { return allocate(bytes, size_t(alignment), true); }
+void operator delete(void *ptr) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, size_t) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { deallocate(ptr); }
@@ -0,0 +1,54 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+
+namespace ees2d::utils {
+
+	class MappedFile {
+		// Read-only memory mapping of a whole file (mmap), unmapped in the destructor
+		// The content is paged in by the OS on first access instead of being copied by read()
+public:
+		explicit MappedFile(const std::string &path);
+		~MappedFile();
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+
+		inline bool isOpen() const { return m_open; }
+		inline const char *data() const { return m_data; }
+		inline size_t size() const { return m_size; }
+		inline std::string_view view() const { return {m_data, m_size}; }
+
+private:
+		const char *m_data = nullptr;
+		size_t m_size = 0;
+		bool m_open = false;
+	};
+
+}// namespace ees2d::utils
@@ -0,0 +1,150 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#include "MemoryReport.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sys/resource.h>
+
+using ees2d::utils::MemoryReport;
+
+
+namespace {
+
+	// Updated by the replacement operator new and delete of HeapCounters.cpp, relaxed : only the totals matter
+	std::atomic<uint64_t> heapAllocations{0};
+	std::atomic<uint64_t> heapDeallocations{0};
+	std::atomic<size_t> heapLiveBytes{0};
+	std::atomic<size_t> heapPeakBytes{0};
+
+	// Value of a "Name:   1234 kB" line of /proc/self/status, in bytes
+	size_t procStatus(const std::string &name) {
+		std::ifstream status("/proc/self/status");
+		std::string line;
+		while (std::getline(status, line)) {
+			if (line.compare(0, name.size() + 1, name + ":") == 0) {
+				return std::strtoull(line.c_str() + name.size() + 1, nullptr, 10) * 1024;
+			}
+		}
+		return 0;
+	}
+
+	double megabytes(size_t bytes) { return bytes / (1024.0 * 1024.0); }
+
+}// namespace
+
+
+void MemoryReport::add(const std::string &subsystem, const std::string &array, size_t bytes) {
+	m_entries.push_back({subsystem, array, bytes});
+}
+
+//---------------------------------------------------------------
+size_t MemoryReport::heapBytes(const std::vector<std::string> &strings) {
+	size_t bytes = blockBytes(strings.capacity() * sizeof(std::string));
+	for (auto &string : strings) {
+		if (string.capacity() >= sizeof(std::string)) {// Short strings are stored inside the object
+			bytes += blockBytes(string.capacity() + 1);
+		}
+	}
+	return bytes;
+}
+
+//---------------------------------------------------------------
+void MemoryReport::countAllocation(size_t bytes) {
+	heapAllocations.fetch_add(1, std::memory_order_relaxed);
+	const size_t live = heapLiveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	size_t peak = heapPeakBytes.load(std::memory_order_relaxed);
+	while (live > peak && !heapPeakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+//---------------------------------------------------------------
+void MemoryReport::countDeallocation(size_t bytes) {
+	heapDeallocations.fetch_add(1, std::memory_order_relaxed);
+	heapLiveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------
+MemoryReport::HeapStats MemoryReport::heapStats() {
+	HeapStats stats;
+	stats.allocations = heapAllocations.load(std::memory_order_relaxed);
+	stats.deallocations = heapDeallocations.load(std::memory_order_relaxed);
+	stats.liveBytes = heapLiveBytes.load(std::memory_order_relaxed);
+	stats.peakBytes = heapPeakBytes.load(std::memory_order_relaxed);
+	return stats;
+}
+
+//---------------------------------------------------------------
+size_t MemoryReport::currentRss() {
+	return procStatus("VmRSS");
+}
+
+//---------------------------------------------------------------
+size_t MemoryReport::peakRss() {
+	const size_t peak = procStatus("VmHWM");
+	if (peak > 0) {
+		return peak;
+	}
+	rusage usage;
+	return getrusage(RUSAGE_SELF, &usage) == 0 ? size_t(usage.ru_maxrss) * 1024 : 0;// Kilobytes on Linux
+}
+
+//---------------------------------------------------------------
+void MemoryReport::report(std::ostream &os, const std::string &stage, size_t numCells) const {
+	const double cells = std::max<size_t>(numCells, 1);
+	os << "[ memory : " << stage << " ] " << numCells << " cells\n";
+	os << std::setw(16) << "subsystem" << std::setw(26) << "array" << std::setw(14) << "size (MB)" << std::setw(14) << "bytes/cell"
+	   << "\n";
+
+	// Entries are listed in the order they were added, each subsystem closed by its total
+	size_t total = 0;
+	for (size_t first = 0; first < m_entries.size();) {
+		size_t subtotal = 0;
+		size_t last = first;
+		for (; last < m_entries.size() && m_entries[last].subsystem == m_entries[first].subsystem; last++) {
+			const Entry &entry = m_entries[last];
+			os << std::setw(16) << entry.subsystem << std::setw(26) << entry.array << std::setw(14) << megabytes(entry.bytes)
+			   << std::setw(14) << entry.bytes / cells << "\n";
+			subtotal += entry.bytes;
+		}
+		os << std::setw(16) << m_entries[first].subsystem << std::setw(26) << "total" << std::setw(14) << megabytes(subtotal)
+		   << std::setw(14) << subtotal / cells << "\n";
+		total += subtotal;
+		first = last;
+	}
+	os << std::setw(42) << "arrays" << std::setw(14) << megabytes(total) << std::setw(14) << total / cells << "\n";
+
+	const HeapStats heap = heapStats();
+	const size_t peak = peakRss();
+	os << std::setw(42) << "peak RSS" << std::setw(14) << megabytes(peak) << std::setw(14) << peak / cells << "\n";
+	os << std::setw(42) << "current RSS" << std::setw(14) << megabytes(currentRss()) << "\n";
+	if (heap.allocations == 0) {
+		return;// Heap counters not linked into this executable
+	}
+	os << std::setw(42) << "heap peak" << std::setw(14) << megabytes(heap.peakBytes) << std::setw(14) << heap.peakBytes / cells << "\n";
+	os << std::setw(42) << "heap live" << std::setw(14) << megabytes(heap.liveBytes) << "\n";
+	os << std::setw(42) << "heap allocations" << std::setw(14) << heap.allocations << std::setw(14) << heap.allocations - heap.deallocations
+	   << " live\n";
+}
@@ -0,0 +1,101 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#pragma once
+
+#include "utils/CsrArray.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace ees2d::utils {
+
+	class MemoryReport {
+		// Bytes held by each array of a run, grouped by subsystem, with the process high-water mark.
+		// Arrays are counted at their capacity plus the heap bookkeeping of every allocation, which is what
+		// makes vectors of small vectors cost far more than their values. Heap allocations of the whole
+		// process are counted by the replacement operator new of HeapCounters.cpp, which is only linked
+		// into EES2D_App (EES2D_HEAP_COUNTERS) : elsewhere the heap counters stay at zero
+public:
+		struct HeapStats {
+			uint64_t allocations = 0;  // Calls to operator new since the start of the process
+			uint64_t deallocations = 0;// Calls to operator delete
+			size_t liveBytes = 0;      // Heap bytes held right now (usable size of each block)
+			size_t peakBytes = 0;      // Highest liveBytes so far
+		};
+
+		static constexpr size_t mallocOverhead = 16;// Bookkeeping and rounding of one heap block
+
+		void add(const std::string &subsystem, const std::string &array, size_t bytes);
+
+		template<class Container>
+		void addArray(const std::string &subsystem, const std::string &array, const Container &container) { add(subsystem, array, heapBytes(container)); }
+
+		// Print every array, the total per subsystem and per cell, the peak RSS and the heap counters
+		void report(std::ostream &os, const std::string &stage, size_t numCells) const;
+
+		static HeapStats heapStats();
+		static void countAllocation(size_t bytes);// Called by the replacement operator new and delete
+		static void countDeallocation(size_t bytes);
+		static size_t currentRss();// Resident set size of the process, 0 when unknown
+		static size_t peakRss();   // High-water mark of the resident set size
+
+		// Heap bytes held by a container
+		static size_t blockBytes(size_t bytes) { return bytes > 0 ? bytes + mallocOverhead : 0; }
+
+		template<class T>
+		static size_t heapBytes(const std::vector<T> &values) { return blockBytes(values.capacity() * sizeof(T)); }
+
+		template<class T>
+		static size_t heapBytes(const std::vector<std::vector<T>> &rows) {
+			size_t bytes = blockBytes(rows.capacity() * sizeof(std::vector<T>));
+			for (auto &row : rows) {
+				bytes += heapBytes(row);
+			}
+			return bytes;
+		}
+
+		static size_t heapBytes(const std::vector<std::string> &strings);
+
+		// A view into a mapped cache file holds no heap memory
+		template<class T>
+		static size_t heapBytes(const CsrArray<T> &array) {
+			return array.isView() ? 0 : blockBytes(array.indexSize() * sizeof(uint32_t)) + blockBytes(array.dataSize() * sizeof(T));
+		}
+
+		template<class T, size_t Stride>
+		static size_t heapBytes(const StridedArray<T, Stride> &array) { return array.isView() ? 0 : blockBytes(array.dataSize() * sizeof(T)); }
+
+private:
+		struct Entry {
+			std::string subsystem;
+			std::string array;
+			size_t bytes;
+		};
+		std::vector<Entry> m_entries;
+	};
+
+}// namespace ees2d::utils
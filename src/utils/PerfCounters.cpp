@@ -0,0 +1,231 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#include "PerfCounters.h"
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using ees2d::utils::PerfCounters;
+
+
+namespace {
+
+#ifdef __linux__
+	constexpr std::array<uint64_t, PerfCounters::numEvents> eventConfigs = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES};
+
+	int openEvent(uint64_t config, int groupFd) {
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = config;
+		attr.disabled = groupFd == -1;// The leader starts the whole group
+		attr.exclude_kernel = 1;      // Allowed with perf_event_paranoid <= 2
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		// pid 0, cpu -1 : the calling thread on whatever cpu it runs
+		return syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+	}
+#endif
+
+	constexpr double cacheLineBytes = 64;
+
+}// namespace
+
+//---------------------------------------------------------------
+PerfCounters::PerfCounters(uint32_t numThreads, std::vector<std::string> phases)
+    : m_phases(std::move(phases)), m_groups(numThreads), m_counts(numThreads * m_phases.size()) {}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+	for (auto &group : m_groups) {
+		for (auto &fd : group.fds) {
+			if (fd != -1) {
+				close(fd);
+			}
+		}
+	}
+#endif
+}
+
+//---------------------------------------------------------------
+void PerfCounters::openThread(uint32_t thread) {
+	ThreadGroup &group = m_groups[thread];
+
+#ifdef __linux__
+	// Cycles lead the group, the other events are optional (LLC misses are often missing in virtual machines)
+	int slot = 0;
+	for (uint32_t event = 0; event < numEvents; event++) {
+		const int fd = openEvent(eventConfigs[event], group.leader);
+		if (fd == -1) {
+			if (event == Cycles) {
+				if (!m_available.exchange(false)) {
+					return;// Already reported by another thread
+				}
+				std::cout << "Hardware counters unavailable (perf_event_open : " << std::strerror(errno)
+				          << "), check /proc/sys/kernel/perf_event_paranoid\n";
+				return;
+			}
+			continue;
+		}
+		if (event == Cycles) {
+			group.leader = fd;
+		}
+		group.fds[event] = fd;
+		group.slots[event] = slot++;
+	}
+
+	ioctl(group.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(group.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#else
+	(void) group;
+	if (m_available.exchange(false)) {
+		std::cout << "Hardware counters unavailable on this platform\n";
+	}
+#endif
+}
+
+//---------------------------------------------------------------
+bool PerfCounters::read(uint32_t thread, std::array<uint64_t, numEvents + 1> &values) const {
+	const ThreadGroup &group = m_groups[thread];
+
+#ifdef __linux__
+	// nr, time enabled, time running, one value per event of the group
+	std::array<uint64_t, 3 + numEvents> buffer;
+	if (::read(group.leader, buffer.data(), sizeof(buffer)) <= 0) {
+		return false;
+	}
+
+	const uint64_t enabled = buffer[1];
+	const uint64_t running = buffer[2];
+	for (uint32_t event = 0; event < numEvents; event++) {
+		const int slot = group.slots[event];
+		uint64_t value = slot == -1 ? 0 : buffer[3 + slot];
+		if (running > 0 && running < enabled) {
+			value = uint64_t(double(value) * enabled / running);
+		}
+		values[event] = value;
+	}
+	values[numEvents] = enabled;
+	return true;
+#else
+	(void) group;
+	(void) values;
+	return false;
+#endif
+}
+
+//---------------------------------------------------------------
+PerfCounters::Scope::Scope(PerfCounters *counters, uint32_t thread, uint32_t phase, uint64_t items)
+    : m_counters(counters), m_thread(thread), m_phase(phase), m_items(items) {
+
+	if (m_counters && (m_counters->m_groups[m_thread].leader == -1 || !m_counters->read(m_thread, m_start))) {
+		m_counters = nullptr;
+	}
+}
+
+PerfCounters::Scope::~Scope() {
+	std::array<uint64_t, numEvents + 1> end;
+	if (!m_counters || !m_counters->read(m_thread, end)) {
+		return;
+	}
+
+	PhaseCounts &counts = m_counters->m_counts[m_thread * m_counters->m_phases.size() + m_phase];
+	for (uint32_t value = 0; value < end.size(); value++) {
+		counts.values[value] += end[value] - m_start[value];
+	}
+	counts.items += m_items;
+}
+
+//---------------------------------------------------------------
+void PerfCounters::report(std::ostream &os) const {
+	if (!available()) {
+		return;
+	}
+
+	// An event is shown if every thread could count it
+	std::array<bool, numEvents> supported;
+	for (uint32_t event = 0; event < numEvents; event++) {
+		supported[event] = true;
+		for (auto &group : m_groups) {
+			supported[event] = supported[event] && group.slots[event] != -1;
+		}
+	}
+
+	os << "[ Hardware counters ] " << m_groups.size() << " threads, memory traffic from LLC misses ("
+	   << cacheLineBytes << " bytes each)\n";
+	os << std::setw(10) << "phase"
+	   << std::setw(14) << "items"
+	   << std::setw(16) << "cycles"
+	   << std::setw(16) << "instructions"
+	   << std::setw(8) << "IPC"
+	   << std::setw(14) << "LLC misses"
+	   << std::setw(14) << "bytes/item"
+	   << std::setw(12) << "GB/s"
+	   << "\n";
+
+	const size_t numPhases = m_phases.size();
+	for (size_t phase = 0; phase < numPhases; phase++) {
+		PhaseCounts total;
+		for (size_t thread = 0; thread < m_groups.size(); thread++) {
+			const PhaseCounts &counts = m_counts[thread * numPhases + phase];
+			for (uint32_t value = 0; value < total.values.size(); value++) {
+				total.values[value] += counts.values[value];
+			}
+			total.items += counts.items;
+		}
+
+		const double cycles = total.values[Cycles];
+		const double instructions = total.values[Instructions];
+		const double bytes = cacheLineBytes * total.values[CacheMisses];
+		const double seconds = 1e-9 * total.values[numEvents] / m_groups.size();// Mean time of a thread in the phase
+
+		os << std::setw(10) << m_phases[phase]
+		   << std::setw(14) << total.items
+		   << std::setw(16) << total.values[Cycles];
+		if (supported[Instructions]) {
+			os << std::setw(16) << total.values[Instructions] << std::setw(8) << (cycles > 0 ? instructions / cycles : 0);
+		} else {
+			os << std::setw(16) << "n/a" << std::setw(8) << "n/a";
+		}
+		if (supported[CacheMisses]) {
+			os << std::setw(14) << total.values[CacheMisses]
+			   << std::setw(14) << (total.items > 0 ? bytes / total.items : 0)
+			   << std::setw(12) << (seconds > 0 ? 1e-9 * bytes / seconds : 0);
+		} else {
+			os << std::setw(14) << "n/a" << std::setw(14) << "n/a" << std::setw(12) << "n/a";
+		}
+		os << "\n";
+	}
+}
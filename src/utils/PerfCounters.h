@@ -0,0 +1,96 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace ees2d::utils {
+
+	class PerfCounters {
+		// Hardware counters of each thread (Linux perf_event_open), one counter group per thread so
+		// cycles, instructions and last level cache misses are read together. Each thread opens its own
+		// group from inside the parallel region and adds the counts of the code it runs to a phase
+		// through Scope. Memory traffic is estimated as one cache line per LLC miss, writebacks are not seen.
+		// When the kernel refuses the counters (no PMU, perf_event_paranoid) the scopes do nothing
+public:
+		enum Event : uint32_t { Cycles,
+			                    Instructions,
+			                    CacheMisses,
+			                    numEvents };
+
+		PerfCounters(uint32_t numThreads, std::vector<std::string> phases);
+		~PerfCounters();
+
+		PerfCounters(const PerfCounters &) = delete;
+		PerfCounters &operator=(const PerfCounters &) = delete;
+
+		// Called once by every thread of the team, counts the calling thread only
+		void openThread(uint32_t thread);
+		inline bool available() const { return m_available.load(std::memory_order_relaxed); }
+
+		class Scope {
+			// Counts of the enclosing scope added to (thread, phase), items processed are used for the per item figures
+public:
+			Scope(PerfCounters *counters, uint32_t thread, uint32_t phase, uint64_t items);
+			~Scope();
+
+private:
+			PerfCounters *m_counters;
+			uint32_t m_thread;
+			uint32_t m_phase;
+			uint64_t m_items;
+			std::array<uint64_t, numEvents + 1> m_start;// Events and elapsed time (ns)
+		};
+
+		// Per phase totals over the threads : IPC, misses and bytes per item, traffic bandwidth
+		void report(std::ostream &os) const;
+
+private:
+		struct alignas(64) PhaseCounts {
+			std::array<uint64_t, numEvents + 1> values = {};// Events and elapsed time (ns)
+			uint64_t items = 0;
+		};
+
+		struct ThreadGroup {
+			int leader = -1;
+			std::array<int, numEvents> fds = {-1, -1, -1};
+			std::array<int, numEvents> slots = {-1, -1, -1};// Position of each event in a group read, -1 if not supported
+		};
+
+		// Events and elapsed time of the calling thread's group, scaled when the counters were multiplexed
+		bool read(uint32_t thread, std::array<uint64_t, numEvents + 1> &values) const;
+
+		std::vector<std::string> m_phases;
+		std::vector<ThreadGroup> m_groups;
+		std::vector<PhaseCounts> m_counts;// m_counts[thread * phases + phase]
+		std::atomic<bool> m_available{true};// False as soon as one thread could not open its group
+	};
+
+}// namespace ees2d::utils
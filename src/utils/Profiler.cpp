@@ -0,0 +1,320 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#include "Profiler.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using ees2d::utils::Profiler;
+
+
+namespace {
+
+	constexpr int32_t noParent = -1;     // Zone entered with nothing open on the thread
+	constexpr int32_t unknownParent = -2;// Zone never entered yet
+	constexpr uint32_t noIteration = uint32_t(-1);
+
+	struct ZoneStats {
+		int64_t total = 0;// ns
+		uint64_t calls = 0;
+		uint32_t iteration = noIteration;// Iteration being accumulated in iterationTotal
+		uint32_t firstIteration = noIteration;
+		int64_t iterationTotal = 0;
+		int64_t maxIteration = 0;
+	};
+
+	struct Event {
+		uint32_t zone;
+		uint32_t iteration;
+		int64_t start;
+		int64_t end;
+	};
+
+	struct ThreadData {
+		uint32_t id = 0;
+		std::array<ZoneStats, Profiler::maxZones> stats;
+
+		// Open zones
+		uint32_t depth = 0;
+		std::array<uint32_t, Profiler::maxDepth> stack;
+		std::array<uint32_t, Profiler::maxDepth> iterations;
+		std::array<int64_t, Profiler::maxDepth> startTimes;
+
+		std::vector<Event> events;
+		uint64_t dropped = 0;
+	};
+
+	struct Registry {
+		Registry() {
+			for (auto &parent : parents) {
+				parent.store(unknownParent, std::memory_order_relaxed);
+			}
+		}
+
+		std::mutex mutex;// Guards names and threads
+		std::vector<std::string> names;
+		std::array<std::atomic<int32_t>, Profiler::maxZones> parents;
+		std::vector<std::unique_ptr<ThreadData>> threads;// Kept after their thread exits
+		std::atomic<uint32_t> iteration{0};
+		int64_t origin = Profiler::now();
+	};
+
+	Registry &registry() {
+		static Registry instance;
+		return instance;
+	}
+
+	thread_local ThreadData *currentThread = nullptr;
+
+	ThreadData &threadData() {
+		if (!currentThread) {
+			Registry &reg = registry();
+			std::lock_guard<std::mutex> lock(reg.mutex);
+			reg.threads.push_back(std::make_unique<ThreadData>());
+			reg.threads.back()->id = reg.threads.size() - 1;
+			currentThread = reg.threads.back().get();
+		}
+		return *currentThread;
+	}
+
+	std::string escape(const std::string &text) {
+		std::string escaped;
+		for (auto &c : text) {
+			if (c == '"' || c == '\\') {
+				escaped += '\\';
+			}
+			escaped += c;
+		}
+		return escaped;
+	}
+
+}// namespace
+
+//---------------------------------------------------------------
+uint32_t Profiler::registerZone(const std::string &name) {
+	Registry &reg = registry();
+	std::lock_guard<std::mutex> lock(reg.mutex);
+
+	auto found = std::find(reg.names.begin(), reg.names.end(), name);
+	if (found != reg.names.end()) {
+		return found - reg.names.begin();
+	}
+	if (reg.names.size() == maxZones) {
+		std::cerr << "Profiler : more than " << maxZones << " zones" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	reg.names.push_back(name);
+	return reg.names.size() - 1;
+}
+
+//---------------------------------------------------------------
+void Profiler::setIteration(uint32_t iteration) {
+	registry().iteration.store(iteration, std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------
+void Profiler::begin(uint32_t zone) {
+	ThreadData &thread = threadData();
+	const uint32_t depth = thread.depth++;
+	if (depth >= maxDepth) {
+		return;// Too deep, only kept balanced
+	}
+
+	std::atomic<int32_t> &parent = registry().parents[zone];
+	if (parent.load(std::memory_order_relaxed) == unknownParent) {
+		int32_t expected = unknownParent;
+		parent.compare_exchange_strong(expected, depth == 0 ? noParent : int32_t(thread.stack[depth - 1]));
+	}
+
+	thread.stack[depth] = zone;
+	thread.iterations[depth] = registry().iteration.load(std::memory_order_relaxed);
+	thread.startTimes[depth] = now();
+}
+
+//---------------------------------------------------------------
+void Profiler::end(uint32_t zone) {
+	const int64_t endTime = now();
+	ThreadData &thread = threadData();
+	const uint32_t depth = --thread.depth;
+	if (depth >= maxDepth) {
+		return;
+	}
+
+	const int64_t startTime = thread.startTimes[depth];
+	const uint32_t iteration = thread.iterations[depth];
+	const int64_t duration = endTime - startTime;
+
+	ZoneStats &stats = thread.stats[zone];
+	stats.total += duration;
+	stats.calls += 1;
+	if (stats.iteration != iteration) {
+		stats.maxIteration = std::max(stats.maxIteration, stats.iterationTotal);
+		stats.iterationTotal = 0;
+		stats.iteration = iteration;
+		stats.firstIteration = std::min(stats.firstIteration, iteration);
+	}
+	stats.iterationTotal += duration;
+
+	if (thread.events.size() < traceCapacity) {
+		thread.events.push_back({zone, iteration, startTime, endTime});
+	} else {
+		thread.dropped += 1;
+	}
+}
+
+//---------------------------------------------------------------
+void Profiler::report(std::ostream &os) {
+	Registry &reg = registry();
+	std::lock_guard<std::mutex> lock(reg.mutex);
+	if (reg.threads.empty()) {
+		return;
+	}
+
+	const uint32_t numZones = reg.names.size();
+
+	// Zones as a tree, children in the order they were registered
+	std::vector<std::vector<uint32_t>> children(numZones);
+	std::vector<uint32_t> roots;
+	for (uint32_t zone = 0; zone < numZones; zone++) {
+		const int32_t parent = reg.parents[zone].load();
+		if (parent == unknownParent) {
+			continue;
+		}
+		if (parent == noParent || uint32_t(parent) == zone) {
+			roots.push_back(zone);
+		} else {
+			children[parent].push_back(zone);
+		}
+	}
+
+	os << "[ profiler ] " << reg.threads.size() << " threads, times of the slowest thread\n";
+	os << std::left << std::setw(32) << "zone" << std::right
+	   << std::setw(12) << "calls"
+	   << std::setw(9) << "threads"
+	   << std::setw(14) << "time (ms)"
+	   << std::setw(15) << "mean/iter (ms)"
+	   << std::setw(14) << "max iter (ms)"
+	   << std::setw(15) << "imbalance (%)"
+	   << "\n";
+
+	std::vector<bool> printed(numZones, false);
+	std::vector<std::pair<uint32_t, uint32_t>> pending;// (zone, depth), depth first
+	for (auto root = roots.rbegin(); root != roots.rend(); ++root) {
+		pending.push_back({*root, 0});
+	}
+
+	uint64_t dropped = 0;
+	for (auto &thread : reg.threads) {
+		dropped += thread->dropped;
+	}
+
+	while (!pending.empty()) {
+		const auto [zone, depth] = pending.back();
+		pending.pop_back();
+		if (printed[zone]) {
+			continue;
+		}
+		printed[zone] = true;
+
+		// Threads do not all enter a zone at every iteration (dynamic tiles), the span of iterations is taken over all of them
+		uint64_t calls = 0;
+		uint32_t threads = 0;
+		uint32_t firstIteration = noIteration;
+		uint32_t lastIteration = 0;
+		int64_t maxThread = 0;
+		int64_t sumThread = 0;
+		int64_t maxIteration = 0;
+		for (auto &thread : reg.threads) {
+			const ZoneStats &stats = thread->stats[zone];
+			if (stats.calls == 0) {
+				continue;
+			}
+			calls += stats.calls;
+			threads += 1;
+			firstIteration = std::min(firstIteration, stats.firstIteration);
+			lastIteration = std::max(lastIteration, stats.iteration);
+			maxThread = std::max(maxThread, stats.total);
+			sumThread += stats.total;
+			maxIteration = std::max({maxIteration, stats.maxIteration, stats.iterationTotal});
+		}
+		const double meanThread = threads > 0 ? double(sumThread) / threads : 0;
+		const uint32_t iterations = threads > 0 ? lastIteration - firstIteration + 1 : 0;
+
+		os << std::left << std::setw(32) << std::string(2 * depth, ' ') + reg.names[zone] << std::right
+		   << std::setw(12) << calls
+		   << std::setw(9) << threads
+		   << std::setw(14) << maxThread * 1e-6
+		   << std::setw(15) << (iterations > 0 ? maxThread * 1e-6 / iterations : 0)
+		   << std::setw(14) << maxIteration * 1e-6
+		   << std::setw(15) << (meanThread > 0 ? 100 * (maxThread / meanThread - 1) : 0)
+		   << "\n";
+
+		for (auto child = children[zone].rbegin(); child != children[zone].rend(); ++child) {
+			pending.push_back({*child, depth + 1});
+		}
+	}
+
+	if (dropped > 0) {
+		os << dropped << " calls past the trace capacity are only in the table\n";
+	}
+}
+
+//---------------------------------------------------------------
+void Profiler::writeTrace(const std::string &path) {
+	Registry &reg = registry();
+	std::lock_guard<std::mutex> lock(reg.mutex);
+
+	std::ofstream trace(path);
+	if (!trace) {
+		std::cerr << "Profiler : can't open trace file " << path << std::endl;
+		return;
+	}
+
+	// Complete events ("X") in microseconds from the start of the run, one tid per recording thread
+	trace << std::fixed << std::setprecision(3);
+	trace << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	bool first = true;
+	for (auto &thread : reg.threads) {
+		trace << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread->id
+		      << ",\"args\":{\"name\":\"thread " << thread->id << "\"}}";
+		first = false;
+
+		for (auto &event : thread->events) {
+			trace << ",\n{\"name\":\"" << escape(reg.names[event.zone]) << "\",\"cat\":\"ees2d\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread->id
+			      << ",\"ts\":" << (event.start - reg.origin) * 1e-3
+			      << ",\"dur\":" << (event.end - event.start) * 1e-3
+			      << ",\"args\":{\"iteration\":" << event.iteration << "}}";
+		}
+	}
+	trace << "\n]}\n";
+
+	std::cout << std::setw(40) << "Profiler trace : " << path << "\n";
+}
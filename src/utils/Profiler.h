@@ -0,0 +1,99 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Scoped profiling zones, compiled in with the EES2D_PROFILE CMake option :
+//     EES2D_PROFILE_ZONE("flux");        time the enclosing scope under "flux"
+//     EES2D_PROFILE_ITERATION(iteration); attribute the following zones to this iteration
+// Without the option both macros expand to nothing and the profiler records nothing
+
+#ifdef EES2D_PROFILE
+#define EES2D_PROFILE_CONCAT_(a, b) a##b
+#define EES2D_PROFILE_CONCAT(a, b) EES2D_PROFILE_CONCAT_(a, b)
+#define EES2D_PROFILE_ZONE(name)                                                                                             \
+	static const uint32_t EES2D_PROFILE_CONCAT(ees2dZoneId, __LINE__) = ees2d::utils::Profiler::registerZone(name); \
+	const ees2d::utils::ProfileZone EES2D_PROFILE_CONCAT(ees2dZone, __LINE__)(EES2D_PROFILE_CONCAT(ees2dZoneId, __LINE__))
+#define EES2D_PROFILE_ITERATION(iteration) ees2d::utils::Profiler::setIteration(iteration)
+#else
+#define EES2D_PROFILE_ZONE(name) ((void) 0)
+#define EES2D_PROFILE_ITERATION(iteration) ((void) 0)
+#endif
+
+
+namespace ees2d::utils {
+
+	class Profiler {
+		// Hierarchical zone profiler. Every thread records into its own buffers (no locking once the
+		// thread is known), a zone's parent is the zone that was open on the thread when it was first entered.
+		// Times are aggregated per zone, per thread and per iteration, and the individual calls are kept
+		// (up to traceCapacity per thread) for a Chrome trace-event file (chrome://tracing, Perfetto).
+		// report() and writeTrace() must be called once the recording threads are done
+public:
+#ifdef EES2D_PROFILE
+		static constexpr bool enabled = true;
+#else
+		static constexpr bool enabled = false;
+#endif
+		static constexpr uint32_t maxZones = 256;
+		static constexpr uint32_t maxDepth = 64;
+		static constexpr size_t traceCapacity = 1 << 20;// Calls kept per thread for the trace, later ones are only aggregated
+
+		// Zones with the same name share their id
+		static uint32_t registerZone(const std::string &name);
+		static void setIteration(uint32_t iteration);
+
+		static void begin(uint32_t zone);
+		static void end(uint32_t zone);
+
+		// Table of the zones as a tree : calls, time of the slowest thread and its mean per iteration,
+		// worst iteration of a single thread and imbalance (slowest thread over the mean of the threads)
+		static void report(std::ostream &os);
+		static void writeTrace(const std::string &path);
+
+		static inline int64_t now() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+	};
+
+	//---------------------------------------------------------------
+
+	class ProfileZone {
+		// Records the enclosing scope, use it through EES2D_PROFILE_ZONE
+public:
+		explicit ProfileZone(uint32_t zone) : m_zone(zone) { Profiler::begin(m_zone); }
+		~ProfileZone() { Profiler::end(m_zone); }
+
+		ProfileZone(const ProfileZone &) = delete;
+		ProfileZone &operator=(const ProfileZone &) = delete;
+
+private:
+		uint32_t m_zone;
+	};
+
+}// namespace ees2d::utils
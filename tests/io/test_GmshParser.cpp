@@ -0,0 +1,65 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#include <gtest/gtest.h>
+#include <io/GmshParser.h>
+#include <io/Su2Parser.h>
+#include <string>
+#include <vector>
+using ees2d::io::GmshParser;
+using ees2d::io::Su2Parser;
+
+// testmesh.msh (ASCII) and testmeshBinary.msh hold the mesh of testmesh.su2, with the four
+// boundary curves in a single "farfield" physical group
+void compareWithSu2(const std::string &path) {
+	// Arrange
+	Su2Parser su2Mesh("../../../tests/testmesh.su2");
+	su2Mesh.Parse();
+	GmshParser gmshMesh(path);
+	gmshMesh.Parse();
+
+	// Assert
+	ASSERT_EQ(su2Mesh.get_Ngrids(), gmshMesh.get_Ngrids());
+	ASSERT_EQ(su2Mesh.get_Nelems(), gmshMesh.get_Nelems());
+	EXPECT_EQ(su2Mesh.get_x(), gmshMesh.get_x());
+	EXPECT_EQ(su2Mesh.get_y(), gmshMesh.get_y());
+	EXPECT_EQ(su2Mesh.get_ElemIndex(), gmshMesh.get_ElemIndex());
+	EXPECT_EQ(su2Mesh.get_NPSUE(), gmshMesh.get_NPSUE());
+	EXPECT_EQ(su2Mesh.get_CONNEC(), gmshMesh.get_CONNEC());
+	EXPECT_EQ(su2Mesh.get_boundaryConditions(), gmshMesh.get_boundaryConditions());
+
+	std::vector<std::string> exactMarkerTags = {"farfield"};
+	std::vector<uint32_t> exactBoundaryMarkers(8, 0);
+	EXPECT_EQ(exactMarkerTags, gmshMesh.get_markerTags());
+	EXPECT_EQ(exactBoundaryMarkers, gmshMesh.get_boundaryMarkers());
+}
+
+
+TEST(Test_GmshParser, parseAscii) {
+	compareWithSu2("../../../tests/testmesh.msh");
+}
+
+
+TEST(Test_GmshParser, parseBinary) {
+	compareWithSu2("../../../tests/testmeshBinary.msh");
+}
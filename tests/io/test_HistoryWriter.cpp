@@ -0,0 +1,56 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D  authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#include <gtest/gtest.h>
+#include <io/HistoryWriter.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+using ees2d::io::HistoryWriter;
+
+TEST(Test_HistoryWriter, writeAndRead) {
+	// Arrange
+	const std::string path = "test_history.bin";
+	const std::vector<std::string> exactColumns = {"iteration", "rms_rho", "CL"};
+	std::vector<std::vector<double>> exactRows;
+	for (uint32_t iteration = 1; iteration <= 150; iteration++) {
+		exactRows.push_back({double(iteration), 1.0 / iteration, 0.01 * iteration});
+	}
+
+	// Act : blocks of 64 records, the last one partial
+	{
+		HistoryWriter history(path, exactColumns, 64);
+		for (auto &row : exactRows) {
+			history.append(row);
+		}
+	}
+	std::vector<std::string> columns;
+	std::vector<std::vector<double>> rows;
+	const bool valid = HistoryWriter::read(path, columns, rows);
+	std::remove(path.c_str());
+
+	// Assert
+	ASSERT_TRUE(valid);
+	ASSERT_EQ(exactColumns, columns);
+	ASSERT_EQ(exactRows, rows);
+}
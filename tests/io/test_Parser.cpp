@@ -48,14 +48,16 @@ TEST(Test_Parser, parseGridInfo) {
 	        {1.0, 1.0}};
 
 
-	std::vector<std::tuple<double, double>> ParsedCOORDS = mymesh.get_coords();
+	std::vector<double> ParsedX = mymesh.get_x();
+	std::vector<double> ParsedY = mymesh.get_y();
 
 
 	// Assert
-	ASSERT_EQ(ExactCoords.size(), ParsedCOORDS.size()) << "Vectors x and y are of unequal length";
+	ASSERT_EQ(ExactCoords.size(), ParsedX.size()) << "Vectors x and y are of unequal length";
+	ASSERT_EQ(ExactCoords.size(), ParsedY.size()) << "Vectors x and y are of unequal length";
 
 	for (size_t i = 0; i < ExactCoords.size(); ++i) {
-		EXPECT_EQ(ExactCoords[i], ParsedCOORDS[i]) << "Vectors ExactCoords and ParsedCoords differ at index " << i;
+		EXPECT_EQ(ExactCoords[i], std::make_tuple(ParsedX[i], ParsedY[i])) << "Vectors ExactCoords and ParsedCoords differ at index " << i;
 	}
 }
 
@@ -125,6 +127,24 @@ TEST(Test_Parser, parseBoundaryConditionsInfo) {
 }
 
 
+TEST(Test_Parser, parseBoundaryMarkers) {
+	// Arrange
+	std::string path = "../../../tests/testmesh.su2";
+	Su2Parser mymesh(path);
+	mymesh.Parse();
+
+	// Act
+	std::vector<std::string> exactMarkerTags = {"farfield", "farfield", "farfield", "farfield"};
+	std::vector<uint32_t> exactBoundaryMarkers = {0, 0, 1, 1, 2, 2, 3, 3};
+
+	// Assert
+	ASSERT_EQ(exactMarkerTags, mymesh.get_markerTags());
+	ASSERT_EQ(exactBoundaryMarkers, mymesh.get_boundaryMarkers());
+	ASSERT_EQ(uint32_t(-3), Su2Parser::boundaryConditionID("farfield"));
+	ASSERT_EQ(uint32_t(-1), Su2Parser::boundaryConditionID("wall"));
+}
+
+
 int main(int argc, char **argv) {
 	testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();
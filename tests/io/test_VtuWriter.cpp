@@ -0,0 +1,518 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+#include "io/AsyncSolutionWriter.h"
+#include "io/InputParser.h"
+#include "io/PointInterpolation.h"
+#include "io/Su2Parser.h"
+#include "io/VtuWriter.h"
+#include "mesh/Connectivity.h"
+#include "mesh/Metrics.h"
+#include "solver/Simulation.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef EES2D_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+using ees2d::io::AsyncSolutionWriter;
+using ees2d::io::InputParser;
+using ees2d::io::PointInterpolation;
+using ees2d::io::Su2Parser;
+using ees2d::io::VtuFormat;
+using ees2d::io::VtuWriter;
+using ees2d::mesh::Connectivity;
+using ees2d::mesh::Mesh;
+using ees2d::mesh::MetricsData;
+using ees2d::solver::Simulation;
+
+
+namespace {
+	// One <DataArray> of a .vtu file, decoded whatever its encoding
+	struct DataArray {
+		std::string name;
+		std::string type;
+		std::vector<double> values;
+		std::vector<uint64_t> header;// UInt64 header of a binary array
+	};
+
+	std::string attribute(const std::string &tag, const std::string &name) {
+		const size_t begin = tag.find(" " + name + "=\"");
+		if (begin == std::string::npos) {
+			return "";
+		}
+		const size_t first = begin + name.size() + 3;
+		return tag.substr(first, tag.find('"', first) - first);
+	}
+
+	std::string decodeBase64(const std::string &text) {
+		std::string bytes;
+		uint32_t word = 0;
+		int bits = 0;
+		for (const char &c : text) {
+			const char *table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+			const char *position = std::strchr(table, c);
+			if (c == '=' || position == nullptr) {
+				continue;
+			}
+			word = word << 6 | uint32_t(position - table);
+			bits += 6;
+			if (bits >= 8) {
+				bits -= 8;
+				bytes += char(word >> bits & 0xff);
+			}
+		}
+		return bytes;
+	}
+
+	size_t base64Length(size_t bytes) { return (bytes + 2) / 3 * 4; }
+
+	std::vector<uint64_t> words(const std::string &bytes) {
+		std::vector<uint64_t> header(bytes.size() / sizeof(uint64_t));
+		std::memcpy(header.data(), bytes.data(), header.size() * sizeof(uint64_t));
+		return header;
+	}
+
+	// Bytes of the header : one size, or [blocks, block size, last block size, compressed size of each block]
+	size_t headerBytes(const std::string &firstWords, bool compressed) {
+		return compressed ? (3 + words(firstWords)[0]) * sizeof(uint64_t) : sizeof(uint64_t);
+	}
+
+	size_t payloadBytes(const std::vector<uint64_t> &header, bool compressed) {
+		size_t bytes = compressed ? 0 : header[0];
+		for (size_t block = 3; compressed && block < header.size(); block++) {
+			bytes += header[block];
+		}
+		return bytes;
+	}
+
+	std::string uncompress(const std::vector<uint64_t> &header, const std::string &payload) {
+		std::string bytes;
+#ifdef EES2D_HAVE_ZLIB
+		size_t offset = 0;
+		for (size_t block = 0; block < header[0]; block++) {
+			const bool partial = block + 1 == header[0] && header[2] != 0;
+			uLongf length = partial ? header[2] : header[1];
+			std::string data(length, '\0');
+			EXPECT_EQ(::uncompress(reinterpret_cast<Bytef *>(&data[0]), &length, reinterpret_cast<const Bytef *>(payload.data() + offset), header[3 + block]), Z_OK);
+			bytes += data.substr(0, length);
+			offset += header[3 + block];
+		}
+#else
+		(void) header;
+		(void) payload;
+#endif
+		return bytes;
+	}
+
+	template<class T>
+	void append(std::vector<double> &values, const std::string &bytes) {
+		for (size_t i = 0; i + sizeof(T) <= bytes.size(); i += sizeof(T)) {
+			T value;
+			std::memcpy(&value, bytes.data() + i, sizeof(T));
+			values.push_back(double(value));
+		}
+	}
+
+	std::vector<DataArray> readVtu(const std::string &path) {
+		std::ifstream stream(path, std::ios::binary);
+		const std::string file((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+		const bool compressed = file.find("compressor=\"vtkZLibDataCompressor\"") != std::string::npos;
+		EXPECT_NE(file.find("header_type=\"UInt64\""), std::string::npos);
+
+		// Offsets of the appended arrays count from the byte following the underscore
+		const size_t appendedTag = file.find("<AppendedData");
+		const size_t appended = appendedTag == std::string::npos ? std::string::npos : file.find('_', appendedTag) + 1;
+
+		std::vector<DataArray> arrays;
+		for (size_t begin = file.find("<DataArray"); begin < appendedTag && begin != std::string::npos; begin = file.find("<DataArray", begin + 1)) {
+			const std::string tag = file.substr(begin, file.find('>', begin) - begin);
+			DataArray array{attribute(tag, "Name"), attribute(tag, "type"), {}, {}};
+			const std::string format = attribute(tag, "format");
+
+			std::string bytes;
+			if (format == "ascii") {
+				const size_t first = file.find('>', begin) + 1;
+				std::istringstream content(file.substr(first, file.find("</DataArray>", first) - first));
+				double value;
+				while (content >> value) {
+					array.values.push_back(value);
+				}
+				arrays.push_back(array);
+				continue;
+			} else if (format == "binary") {
+				// Header and data are encoded separately
+				const size_t first = file.find('>', begin) + 1;
+				const std::string text = file.substr(first, file.find("</DataArray>", first) - first);
+				const size_t textBegin = text.find_first_not_of("\n ");
+				const size_t headerLength = base64Length(headerBytes(decodeBase64(text.substr(textBegin, 32)), compressed));
+				array.header = words(decodeBase64(text.substr(textBegin, headerLength)));
+				bytes = decodeBase64(text.substr(textBegin + headerLength, base64Length(payloadBytes(array.header, compressed))));
+			} else {
+				EXPECT_EQ(format, "appended");
+				const size_t first = appended + std::stoull(attribute(tag, "offset"));
+				const size_t length = headerBytes(file.substr(first, 3 * sizeof(uint64_t)), compressed);
+				array.header = words(file.substr(first, length));
+				bytes = file.substr(first + length, payloadBytes(array.header, compressed));
+			}
+
+			if (compressed) {
+				bytes = uncompress(array.header, bytes);
+			}
+			if (array.type == "Float64") {
+				append<double>(array.values, bytes);
+			} else if (array.type == "Float32") {
+				append<float>(array.values, bytes);
+			} else if (array.type == "UInt32") {
+				append<uint32_t>(array.values, bytes);
+			} else if (array.type == "UInt8") {
+				append<uint8_t>(array.values, bytes);
+			} else {
+				ADD_FAILURE() << "Unexpected array type " << array.type;
+			}
+			arrays.push_back(array);
+		}
+		return arrays;
+	}
+
+	// Same arrays, values equal to the precision of the ascii file (6 digits) or of Float32
+	void expectSameArrays(const std::vector<DataArray> &ascii, const std::vector<DataArray> &decoded, const std::string &encoding) {
+		ASSERT_EQ(ascii.size(), decoded.size()) << encoding;
+		for (size_t iarray = 0; iarray < ascii.size(); iarray++) {
+			EXPECT_EQ(ascii[iarray].name, decoded[iarray].name) << encoding;
+			ASSERT_EQ(ascii[iarray].values.size(), decoded[iarray].values.size()) << encoding << " array " << ascii[iarray].name;
+			for (size_t i = 0; i < ascii[iarray].values.size(); i++) {
+				const double tolerance = 1e-5 * std::max(1.0, std::abs(ascii[iarray].values[i]));
+				EXPECT_NEAR(ascii[iarray].values[i], decoded[iarray].values[i], tolerance)
+				        << encoding << " array " << ascii[iarray].name << " differs at index " << i;
+			}
+		}
+	}
+
+	const DataArray *find(const std::vector<DataArray> &arrays, const std::string &name) {
+		for (auto &array : arrays) {
+			if (array.name == name) {
+				return &array;
+			}
+		}
+		return nullptr;
+	}
+}// namespace
+
+
+class Test_VtuWriter : public ::testing::Test {
+protected:
+	void SetUp() override {
+		std::string inputFilePath = "../../../tests/io/testmesh.ees2d";
+		parameters = std::make_unique<InputParser>(inputFilePath);
+		parameters->parse();
+
+		parser = std::make_unique<Su2Parser>(parameters->m_meshFile);
+		parser->Parse();
+		connectivity = std::make_unique<Connectivity>(*parser);
+		connectivity->solve();
+		metrics.compute(*connectivity);
+		mesh = std::make_unique<Mesh>(*connectivity, metrics);
+		sim = std::make_unique<Simulation>(*mesh, *parameters);
+
+		// Distinct values in every cell, so a wrong order or offset shows
+		for (size_t ielem = 0; ielem < sim->p.size(); ielem++) {
+			sim->p[ielem] = 1.0 + 0.125 * ielem;
+			sim->rho[ielem] = 0.5 + 0.01 * ielem;
+			sim->Mach[ielem] = 0.3 + 1e-3 * ielem;
+			sim->u[ielem] = 0.7 - 0.05 * ielem;
+			sim->v[ielem] = -0.1 * ielem;
+		}
+	}
+
+	std::vector<DataArray> writeAndRead(std::string path, const VtuFormat &format, uint32_t firstElem = 0, uint32_t lastElem = 0,
+	                                    const PointInterpolation *interpolation = nullptr) {
+		VtuWriter writer(path, *connectivity, *mesh, *sim, format);
+		if (lastElem > firstElem) {
+			writer.setPiece(firstElem, lastElem);
+		}
+		writer.setPointInterpolation(interpolation);
+		writer.writeSolution();
+		std::vector<DataArray> arrays = readVtu(path);
+		std::remove(path.c_str());
+		return arrays;
+	}
+
+	std::unique_ptr<InputParser> parameters;
+	std::unique_ptr<Su2Parser> parser;
+	std::unique_ptr<Connectivity> connectivity;
+	MetricsData metrics;
+	std::unique_ptr<Mesh> mesh;
+	std::unique_ptr<Simulation> sim;
+};
+
+
+TEST_F(Test_VtuWriter, binaryEncodingsMatchAscii) {
+	// Arrange
+	const std::vector<DataArray> ascii = writeAndRead("test_VtuWriter_ascii.vtu", VtuFormat());
+	ASSERT_NE(find(ascii, "Pression"), nullptr);
+	ASSERT_EQ(find(ascii, "Pression")->values.size(), sim->p.size());
+
+	VtuFormat base64;
+	base64.encoding = VtuFormat::Encoding::BASE64;
+	VtuFormat raw;
+	raw.encoding = VtuFormat::Encoding::RAW;
+	VtuFormat raw32 = raw;
+	raw32.float32 = true;
+
+	// Act
+	const std::vector<DataArray> base64Arrays = writeAndRead("test_VtuWriter_base64.vtu", base64);
+	const std::vector<DataArray> rawArrays = writeAndRead("test_VtuWriter_raw.vtu", raw);
+	const std::vector<DataArray> raw32Arrays = writeAndRead("test_VtuWriter_raw32.vtu", raw32);
+
+	// Assert
+	expectSameArrays(ascii, base64Arrays, "base64");
+	expectSameArrays(ascii, rawArrays, "raw appended");
+	expectSameArrays(ascii, raw32Arrays, "raw appended Float32");
+
+	for (auto &array : base64Arrays) {
+		ASSERT_EQ(array.header.size(), 1u);
+		EXPECT_EQ(array.header[0], array.values.size() * (array.type == "Float64" ? 8 : array.type == "UInt32" ? 4 : 1)) << array.name;
+	}
+	EXPECT_EQ(find(raw32Arrays, "Pression")->type, "Float32");
+	EXPECT_EQ(find(raw32Arrays, "velocity")->type, "Float32");
+	EXPECT_EQ(raw32Arrays.front().type, "Float64") << "points are always written in double precision";
+}
+
+
+#ifdef EES2D_HAVE_ZLIB
+TEST_F(Test_VtuWriter, zlibBlocksMatchAscii) {
+	// Arrange
+	const std::vector<DataArray> ascii = writeAndRead("test_VtuWriter_ascii.vtu", VtuFormat());
+
+	VtuFormat base64;
+	base64.encoding = VtuFormat::Encoding::BASE64;
+	base64.compress = true;
+	VtuFormat raw;
+	raw.encoding = VtuFormat::Encoding::RAW;
+	raw.compress = true;
+
+	// Act
+	const std::vector<DataArray> base64Arrays = writeAndRead("test_VtuWriter_base64_zlib.vtu", base64);
+	const std::vector<DataArray> rawArrays = writeAndRead("test_VtuWriter_raw_zlib.vtu", raw);
+
+	// Assert
+	expectSameArrays(ascii, base64Arrays, "base64 zlib");
+	expectSameArrays(ascii, rawArrays, "raw appended zlib");
+
+	// [number of blocks, block size, size of the last partial block, compressed size of each block]
+	for (auto &array : rawArrays) {
+		const size_t bytes = array.values.size() * (array.type == "Float64" ? 8 : array.type == "UInt32" ? 4 : 1);
+		ASSERT_GE(array.header.size(), 3u);
+		EXPECT_EQ(array.header[0], (bytes + 32767) / 32768) << array.name;
+		EXPECT_EQ(array.header[1], 32768u) << array.name;
+		EXPECT_EQ(array.header[2], bytes % 32768) << array.name;
+		EXPECT_EQ(array.header.size(), 3 + array.header[0]) << array.name;
+	}
+}
+#endif
+
+
+TEST_F(Test_VtuWriter, pieceRenumbersNodes) {
+	// Arrange
+	const uint32_t firstElem = 2;
+	const uint32_t lastElem = 6;
+	const std::vector<uint32_t> &ElemIndex = parser->get_ElemIndex();
+	const std::vector<uint32_t> &CONNEC = parser->get_CONNEC();
+
+	VtuFormat raw;
+	raw.encoding = VtuFormat::Encoding::RAW;
+
+	// Act
+	const std::vector<DataArray> ascii = writeAndRead("test_VtuWriter_piece.vtu", VtuFormat(), firstElem, lastElem);
+	const std::vector<DataArray> rawArrays = writeAndRead("test_VtuWriter_piece_raw.vtu", raw, firstElem, lastElem);
+
+	// Assert : each local node ID points to the coordinates of the global node it replaces
+	expectSameArrays(ascii, rawArrays, "raw appended piece");
+	const std::vector<double> &points = ascii.front().values;
+	const std::vector<double> &connec = find(ascii, "connectivity")->values;
+	ASSERT_EQ(connec.size(), ElemIndex[lastElem] - ElemIndex[firstElem]);
+	for (size_t i = 0; i < connec.size(); i++) {
+		const uint32_t local = uint32_t(connec[i]);
+		const uint32_t global = CONNEC[ElemIndex[firstElem] + i];
+		ASSERT_LT(3 * local + 1, points.size());
+		EXPECT_EQ(points[3 * local], parser->get_x()[global]) << "node " << i << " of the piece";
+		EXPECT_EQ(points[3 * local + 1], parser->get_y()[global]) << "node " << i << " of the piece";
+	}
+
+	const std::vector<double> &offsets = find(ascii, "offsets")->values;
+	ASSERT_EQ(offsets.size(), lastElem - firstElem);
+	EXPECT_EQ(offsets.back(), connec.size());
+
+	const std::vector<double> &pressure = find(ascii, "Pression")->values;
+	ASSERT_EQ(pressure.size(), lastElem - firstElem);
+	for (uint32_t i = 0; i < pressure.size(); i++) {
+		EXPECT_DOUBLE_EQ(pressure[i], sim->p[firstElem + i]) << "cell " << i << " of the piece";
+	}
+}
+
+
+TEST_F(Test_VtuWriter, pointInterpolationWeightsSumToOne) {
+	// Arrange
+	const PointInterpolation interpolation(*connectivity, *mesh);
+	const uint32_t numNodes = parser->get_Ngrids();
+	const std::vector<double> constant(sim->p.size(), 2.5);
+	std::vector<double> nodeValues(numNodes);
+	std::vector<double> pressure(numNodes);
+
+	// Nodes of the piece path, in decreasing order so they differ from their positions
+	std::vector<uint32_t> nodes;
+	for (uint32_t inode = numNodes; inode > 0; inode -= 3) {
+		nodes.push_back(inode - 1);
+	}
+	std::vector<double> pieceValues(nodes.size());
+
+	// Act
+	interpolation.interpolate(constant.data(), nullptr, numNodes, nodeValues.data());
+	interpolation.interpolate(sim->p.data(), nullptr, numNodes, pressure.data());
+	interpolation.interpolate(sim->p.data(), nodes.data(), nodes.size(), pieceValues.data());
+
+	// Assert : the weights around a node sum to 1, and are positive so the value lies between the values of these cells
+	const auto esup1 = connectivity->get_esup1();
+	const auto esup2 = connectivity->get_esup2();
+	for (uint32_t inode = 0; inode < numNodes; inode++) {
+		EXPECT_NEAR(nodeValues[inode], 2.5, 1e-12) << "node " << inode;
+
+		double lowest = sim->p[esup1[esup2[inode]]];
+		double highest = lowest;
+		for (uint32_t iesup = esup2[inode]; iesup < esup2[inode + 1]; iesup++) {
+			lowest = std::min(lowest, sim->p[esup1[iesup]]);
+			highest = std::max(highest, sim->p[esup1[iesup]]);
+		}
+		EXPECT_GE(pressure[inode], lowest - 1e-12) << "node " << inode;
+		EXPECT_LE(pressure[inode], highest + 1e-12) << "node " << inode;
+	}
+	for (size_t i = 0; i < nodes.size(); i++) {
+		EXPECT_EQ(pieceValues[i], pressure[nodes[i]]) << "node " << nodes[i] << " of the piece";
+	}
+}
+
+
+TEST_F(Test_VtuWriter, pointDataOfConstantFieldIsConstant) {
+	// Arrange
+	for (size_t ielem = 0; ielem < sim->p.size(); ielem++) {
+		sim->p[ielem] = 1.25;
+		sim->rho[ielem] = 0.75;
+		sim->Mach[ielem] = 0.5;
+		sim->u[ielem] = 0.625;
+		sim->v[ielem] = -0.375;
+	}
+	const PointInterpolation interpolation(*connectivity, *mesh);
+	VtuFormat raw;
+	raw.encoding = VtuFormat::Encoding::RAW;
+
+	// Act : whole mesh and piece, the piece uses the node list of the piece
+	for (auto [firstElem, lastElem] : {std::make_pair(0u, 0u), std::make_pair(2u, 6u)}) {
+		for (auto &format : {VtuFormat(), raw}) {
+			const std::vector<DataArray> arrays = writeAndRead("test_VtuWriter_points.vtu", format, firstElem, lastElem, &interpolation);
+
+			// Assert : the point arrays come before the cell arrays of the same name, one value (or vector) per point
+			std::vector<uint32_t> pieceNodes(parser->get_CONNEC().begin() + parser->get_ElemIndex()[firstElem],
+			                                 parser->get_CONNEC().begin() + parser->get_ElemIndex()[lastElem]);
+			std::sort(pieceNodes.begin(), pieceNodes.end());
+			pieceNodes.erase(std::unique(pieceNodes.begin(), pieceNodes.end()), pieceNodes.end());
+			const size_t numPoints = lastElem > firstElem ? pieceNodes.size() : parser->get_Ngrids();
+			ASSERT_EQ(arrays.front().values.size(), 3 * numPoints);
+
+			for (auto &[name, value] : {std::make_pair("Pression", 1.25), std::make_pair("Density", 0.75), std::make_pair("Mach", 0.5)}) {
+				ASSERT_NE(find(arrays, name), nullptr) << name;
+				const std::vector<double> &values = find(arrays, name)->values;
+				ASSERT_EQ(values.size(), numPoints) << name;
+				for (size_t i = 0; i < numPoints; i++) {
+					EXPECT_NEAR(values[i], value, 1e-12) << name << " at point " << i;
+				}
+			}
+			const std::vector<double> &velocity = find(arrays, "velocity")->values;
+			ASSERT_EQ(velocity.size(), 3 * numPoints);
+			for (size_t i = 0; i < numPoints; i++) {
+				EXPECT_NEAR(velocity[3 * i], 0.625, 1e-12) << "velocity at point " << i;
+				EXPECT_NEAR(velocity[3 * i + 1], -0.375, 1e-12) << "velocity at point " << i;
+			}
+		}
+	}
+}
+
+
+TEST_F(Test_VtuWriter, asyncSnapshotsKeepTheirValues) {
+	// Arrange
+	const std::vector<uint32_t> iterations = {10, 20, 30, 40};
+	AsyncSolutionWriter writer("test_VtuWriter_async.vtu", *connectivity, *mesh, *sim, VtuFormat());
+
+	// Act : the solution changes right after each submit, while the previous snapshots may still be written
+	for (uint32_t iteration : iterations) {
+		for (size_t ielem = 0; ielem < sim->p.size(); ielem++) {
+			sim->p[ielem] = iteration + 0.125 * ielem;
+			sim->u[ielem] = -0.5 * iteration;
+		}
+		writer.submit(iteration);
+	}
+	for (size_t ielem = 0; ielem < sim->p.size(); ielem++) {
+		sim->p[ielem] = -1.0;
+	}
+	writer.finish();
+
+	// Assert : each file holds the solution of its own submit
+	for (uint32_t iteration : iterations) {
+		const std::string path = "test_VtuWriter_async_" + std::to_string(iteration) + ".vtu";
+		const std::vector<DataArray> arrays = readVtu(path);
+		std::remove(path.c_str());
+		ASSERT_NE(find(arrays, "Pression"), nullptr) << path;
+		const std::vector<double> &pressure = find(arrays, "Pression")->values;
+		const std::vector<double> &velocity = find(arrays, "velocity")->values;
+		ASSERT_EQ(pressure.size(), sim->p.size()) << path;
+		ASSERT_EQ(velocity.size(), 3 * sim->p.size()) << path;
+		for (size_t ielem = 0; ielem < pressure.size(); ielem++) {
+			const double expected = iteration + 0.125 * ielem;
+			EXPECT_NEAR(pressure[ielem], expected, 1e-5 * expected) << path << " cell " << ielem;
+			EXPECT_NEAR(velocity[3 * ielem], -0.5 * iteration, 1e-5 * iteration) << path << " cell " << ielem;
+		}
+	}
+
+	// The time series lists the snapshots in submit order, relative to the .pvd
+	std::ifstream index("test_VtuWriter_async.pvd");
+	std::vector<std::pair<std::string, std::string>> dataSets;
+	for (std::string line; std::getline(index, line);) {
+		if (line.find("<DataSet") != std::string::npos) {
+			dataSets.emplace_back(attribute(line, "timestep"), attribute(line, "file"));
+		}
+	}
+	index.close();
+	std::remove("test_VtuWriter_async.pvd");
+	ASSERT_EQ(dataSets.size(), iterations.size());
+	for (size_t i = 0; i < iterations.size(); i++) {
+		EXPECT_EQ(dataSets[i].first, std::to_string(iterations[i]));
+		EXPECT_EQ(dataSets[i].second, "test_VtuWriter_async_" + std::to_string(iterations[i]) + ".vtu");
+	}
+}
@@ -154,7 +154,10 @@ TEST(Test_Connectivity, solveElemSurrElem) {
 	ASSERT_EQ(esuel->size(), exactesuel.size()) << "arrays esuel are of unequal length";
 
 	for (size_t i = 0; i < exactesuel.size(); ++i) {
-		EXPECT_EQ(exactesuel[i], (*esuel)[i]) << "arrays psup1 differ at index " << i;
+		ASSERT_EQ(exactesuel[i].size(), esuel->rowSize(i)) << "arrays psup1 differ at index " << i;
+		for (size_t j = 0; j < exactesuel[i].size(); ++j) {
+			EXPECT_EQ(exactesuel[i][j], (*esuel)(i, j)) << "arrays psup1 differ at index " << i;
+		}
 	}
 }
 
@@ -181,7 +184,10 @@ TEST(Test_Connectivity, solveNodeSurrFace) {
 	ASSERT_EQ(NodeSurrFace->size(), exactNodeSurrFace.size()) << "arrays esuel are of unequal length";
 
 	for (size_t i = 0; i < exactNodeSurrFace.size(); ++i) {
-		EXPECT_EQ(exactNodeSurrFace[i], (*NodeSurrFace)[i]) << "arrays psup1 differ at index " << i;
+		ASSERT_EQ(exactNodeSurrFace[i].size(), NodeSurrFace->rowSize(i)) << "arrays psup1 differ at index " << i;
+		for (size_t j = 0; j < exactNodeSurrFace[i].size(); ++j) {
+			EXPECT_EQ(exactNodeSurrFace[i][j], (*NodeSurrFace)(i, j)) << "arrays psup1 differ at index " << i;
+		}
 	}
 }
 
@@ -211,7 +217,10 @@ TEST(Test_Connectivity, solveFaceSurrElem) {
 	ASSERT_EQ(FaceSurrElem->size(), ExactFaceSurrElem.size()) << "arrays Element to face are of unequal length";
 
 	for (size_t i = 0; i < ExactFaceSurrElem.size(); ++i) {
-		EXPECT_EQ(ExactFaceSurrElem[i], (*FaceSurrElem)[i]) << "arrays Element to face differ at index " << i;
+		ASSERT_EQ(ExactFaceSurrElem[i].size(), FaceSurrElem->rowSize(i)) << "arrays Element to face differ at index " << i;
+		for (size_t j = 0; j < ExactFaceSurrElem[i].size(); ++j) {
+			EXPECT_EQ(ExactFaceSurrElem[i][j], (*FaceSurrElem)(i, j)) << "arrays Element to face differ at index " << i;
+		}
 	}
 }
 
@@ -237,6 +246,79 @@ TEST(Test_Connectivity, solveElemSurrFace) {
 	ASSERT_EQ(ElemSurrFace->size(), ExactElemSurrFace.size()) << "arrays Element to face are of unequal length";
 
 	for (size_t i = 0; i < ExactElemSurrFace.size(); ++i) {
-		EXPECT_EQ(ExactElemSurrFace[i], (*ElemSurrFace)[i]) << "arrays Element to face differ at index " << i;
+		ASSERT_EQ(ExactElemSurrFace[i].size(), ElemSurrFace->rowSize(i)) << "arrays Element to face differ at index " << i;
+		for (size_t j = 0; j < ExactElemSurrFace[i].size(); ++j) {
+			EXPECT_EQ(ExactElemSurrFace[i][j], (*ElemSurrFace)(i, j)) << "arrays Element to face differ at index " << i;
+		}
+	}
+}
+
+TEST(Test_Connectivity, solveFaceToMarker) {
+	// Arrange
+	std::string path = "../../../tests/testmesh.su2";
+
+	Su2Parser parser(path);
+	parser.Parse();
+
+	Connectivity connectivity(parser);
+	connectivity.solve();
+
+	// Act
+	const uint32_t none = Connectivity::noMarker;
+	std::vector<uint32_t> exactFaceToMarker{0, 3, none, none, 0, none, 1, none,
+	                                        3, none, none, none, none, 1, 2, 2};
+
+	auto faceToMarker = connectivity.get_FaceToMarker();
+
+	ASSERT_EQ(exactFaceToMarker.size(), faceToMarker->size()) << "arrays Face to marker are of unequal length";
+
+	for (size_t i = 0; i < exactFaceToMarker.size(); ++i) {
+		EXPECT_EQ(exactFaceToMarker[i], (*faceToMarker)[i]) << "arrays Face to marker differ at index " << i;
+	}
+}
+
+TEST(Test_Connectivity, solveMixedMesh) {
+	// Arrange : one quadrilateral and two triangles
+	std::string path = "../../../tests/testmeshMixed.su2";
+
+	Su2Parser parser(path);
+	parser.Parse();
+
+	Connectivity connectivity(parser);
+	connectivity.solve();
+
+	// Act
+	const uint32_t wall = uint32_t(-1);
+	const uint32_t farfield = uint32_t(-3);
+	std::vector<std::vector<uint32_t>> exactFaceToNode{{0, 1}, {0, 3}, {1, 4}, {1, 2}, {1, 5}, {2, 5}, {3, 4}, {4, 5}};
+	std::vector<std::vector<uint32_t>> exactElemToFace{{0, 2, 6, 1}, {3, 5, 4}, {4, 7, 2}};
+	std::vector<std::vector<uint32_t>> exactFaceToElem{{0, wall}, {0, farfield}, {0, 2}, {1, wall},
+	                                                   {1, 2}, {1, farfield}, {0, farfield}, {2, farfield}};
+	std::vector<std::vector<uint32_t>> exactElemToElem{{2, wall, farfield, farfield}, {2, wall, farfield}, {1, 0, farfield}};
+
+	auto faceToNode = connectivity.get_FaceToNode();
+	auto elemToFace = connectivity.get_ElemToFace();
+	auto faceToElem = connectivity.get_FaceToElem();
+	auto elemToElem = connectivity.get_elemToElem();
+
+	// Assert
+	ASSERT_EQ(faceToNode->size(), exactFaceToNode.size()) << "arrays Face to node are of unequal length";
+	ASSERT_EQ(faceToElem->size(), exactFaceToElem.size()) << "arrays Face to element are of unequal length";
+	for (size_t i = 0; i < exactFaceToNode.size(); ++i) {
+		for (size_t j = 0; j < 2; ++j) {
+			EXPECT_EQ(exactFaceToNode[i][j], (*faceToNode)(i, j)) << "arrays Face to node differ at index " << i;
+			EXPECT_EQ(exactFaceToElem[i][j], (*faceToElem)(i, j)) << "arrays Face to element differ at index " << i;
+		}
+	}
+
+	ASSERT_EQ(elemToFace->size(), exactElemToFace.size()) << "arrays Element to face are of unequal length";
+	ASSERT_EQ(elemToElem->size(), exactElemToElem.size()) << "arrays Element to element are of unequal length";
+	for (size_t i = 0; i < exactElemToFace.size(); ++i) {
+		ASSERT_EQ(exactElemToFace[i].size(), elemToFace->rowSize(i)) << "arrays Element to face differ at index " << i;
+		ASSERT_EQ(exactElemToElem[i].size(), elemToElem->rowSize(i)) << "arrays Element to element differ at index " << i;
+		for (size_t j = 0; j < exactElemToFace[i].size(); ++j) {
+			EXPECT_EQ(exactElemToFace[i][j], (*elemToFace)(i, j)) << "arrays Element to face differ at index " << i;
+			EXPECT_EQ(exactElemToElem[i][j], (*elemToElem)(i, j)) << "arrays Element to element differ at index " << i;
+		}
 	}
 }
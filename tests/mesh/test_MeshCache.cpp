@@ -0,0 +1,196 @@
+/* ---------------------------------------------------------------------
+ *
+ * Copyright (C) 2020 - by the EES2D authors
+ *
+ * This file is part of EES2D.
+ *
+ *   EES2D is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   EES2D is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with EES2D.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * Authors: Amin Ouled-Mohamed & Ali Omais, Polytechnique Montreal, 2020-
+ */
+
+
+#include "io/Su2Parser.h"
+#include "mesh/Connectivity.h"
+#include "mesh/MeshCache.h"
+#include "mesh/Metrics.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <vector>
+
+
+using ees2d::io::Su2Parser;
+using ees2d::mesh::Connectivity;
+using ees2d::mesh::MeshCache;
+using ees2d::mesh::MetricsData;
+
+
+TEST(Test_MeshCache, writeAndRead) {
+	// Arrange
+	std::string path = "../../../tests/testmeshMixed.su2";
+	std::string cachePath = "test_MeshCache.cache";
+	std::remove(cachePath.c_str());
+
+	Su2Parser parser(path);
+	parser.Parse();
+	Connectivity connectivity(parser);
+	connectivity.solve();
+	MetricsData metrics;
+	metrics.compute(connectivity);
+
+	MeshCache cache(path, cachePath);
+	ASSERT_FALSE(cache.open()) << "cache should not exist yet";
+	ASSERT_TRUE(cache.write(parser, connectivity, metrics));
+
+	// Act
+	MeshCache cached(path, cachePath);
+	ASSERT_TRUE(cached.open());
+
+	Su2Parser cachedParser(path);
+	cached.read(cachedParser);
+	Connectivity cachedConnectivity(cachedParser);
+	ASSERT_TRUE(cached.read(cachedConnectivity));
+	MetricsData cachedMetrics;
+	cached.read(cachedMetrics);
+
+	// Assert
+	EXPECT_EQ(parser.get_Ngrids(), cachedParser.get_Ngrids());
+	EXPECT_EQ(parser.get_Nelems(), cachedParser.get_Nelems());
+	EXPECT_EQ(parser.get_x(), cachedParser.get_x());
+	EXPECT_EQ(parser.get_y(), cachedParser.get_y());
+	EXPECT_EQ(parser.get_CONNEC(), cachedParser.get_CONNEC());
+	EXPECT_EQ(parser.get_NPSUE(), cachedParser.get_NPSUE());
+	EXPECT_EQ(parser.get_ElemIndex(), cachedParser.get_ElemIndex());
+	EXPECT_EQ(parser.get_boundaryConditions(), cachedParser.get_boundaryConditions());
+	EXPECT_EQ(parser.get_markerTags(), cachedParser.get_markerTags());
+	EXPECT_EQ(parser.get_boundaryMarkers(), cachedParser.get_boundaryMarkers());
+
+	for (uint32_t i = 0; i < connectivity.get_esup2_size(); i++) {
+		EXPECT_EQ(connectivity.get_esup2()[i], cachedConnectivity.get_esup2()[i]) << "arrays esup2 differ at index " << i;
+	}
+	for (uint32_t i = 0; i < connectivity.get_esup1_size(); i++) {
+		EXPECT_EQ(connectivity.get_esup1()[i], cachedConnectivity.get_esup1()[i]) << "arrays esup1 differ at index " << i;
+	}
+	EXPECT_EQ(*connectivity.get_psup1(), *cachedConnectivity.get_psup1());
+	auto values = [](const uint32_t *begin, size_t count) { return std::vector<uint32_t>(begin, begin + count); };
+	auto index = [&values](const IntCsrArray *array) { return values(array->index(), array->indexSize()); };
+	auto data = [&values](const auto *array) { return values(array->data(), array->dataSize()); };
+	EXPECT_TRUE(cachedConnectivity.get_elemToElem()->isView()) << "cached tables should be used in place";
+	EXPECT_EQ(index(connectivity.get_elemToElem()), index(cachedConnectivity.get_elemToElem()));
+	EXPECT_EQ(data(connectivity.get_elemToElem()), data(cachedConnectivity.get_elemToElem()));
+	EXPECT_EQ(index(connectivity.get_ElemToFace()), index(cachedConnectivity.get_ElemToFace()));
+	EXPECT_EQ(data(connectivity.get_ElemToFace()), data(cachedConnectivity.get_ElemToFace()));
+	EXPECT_EQ(data(connectivity.get_FaceToNode()), data(cachedConnectivity.get_FaceToNode()));
+	EXPECT_EQ(data(connectivity.get_FaceToElem()), data(cachedConnectivity.get_FaceToElem()));
+	EXPECT_EQ(*connectivity.get_FaceToMarker(), *cachedConnectivity.get_FaceToMarker());
+
+	EXPECT_EQ(metrics.facesSurface, cachedMetrics.facesSurface);
+	EXPECT_EQ(metrics.CvolumesArea, cachedMetrics.CvolumesArea);
+	ASSERT_EQ(metrics.facesVector.size(), cachedMetrics.facesVector.size());
+	for (size_t i = 0; i < metrics.facesVector.size(); i++) {
+		EXPECT_EQ(metrics.facesVector[i].x, cachedMetrics.facesVector[i].x) << "faces vectors differ at index " << i;
+		EXPECT_EQ(metrics.facesVector[i].y, cachedMetrics.facesVector[i].y) << "faces vectors differ at index " << i;
+		EXPECT_EQ(metrics.facesMidPoint[i].x, cachedMetrics.facesMidPoint[i].x) << "faces mid-points differ at index " << i;
+		EXPECT_EQ(metrics.facesMidPoint[i].y, cachedMetrics.facesMidPoint[i].y) << "faces mid-points differ at index " << i;
+	}
+	ASSERT_EQ(metrics.CvolumesCentroid.size(), cachedMetrics.CvolumesCentroid.size());
+	for (size_t i = 0; i < metrics.CvolumesCentroid.size(); i++) {
+		EXPECT_EQ(metrics.CvolumesCentroid[i].x, cachedMetrics.CvolumesCentroid[i].x) << "centroids differ at index " << i;
+		EXPECT_EQ(metrics.CvolumesCentroid[i].y, cachedMetrics.CvolumesCentroid[i].y) << "centroids differ at index " << i;
+	}
+
+	std::remove(cachePath.c_str());
+}
+
+TEST(Test_MeshCache, rejectOtherMesh) {
+	// Arrange : cache built from one mesh file
+	std::string cachePath = "test_MeshCache_other.cache";
+	std::remove(cachePath.c_str());
+
+	Su2Parser parser("../../../tests/testmesh.su2");
+	parser.Parse();
+	Connectivity connectivity(parser);
+	connectivity.solve();
+	MetricsData metrics;
+	metrics.compute(connectivity);
+
+	MeshCache cache("../../../tests/testmesh.su2", cachePath);
+	cache.open();
+	ASSERT_TRUE(cache.write(parser, connectivity, metrics));
+
+	// Act : same cache file, different mesh file
+	MeshCache other("../../../tests/testmeshMixed.su2", cachePath);
+
+	// Assert
+	EXPECT_FALSE(other.open());
+
+	std::remove(cachePath.c_str());
+}
+
+TEST(Test_MeshCache, rejectModifiedMesh) {
+	// Arrange : cache built from a copy of a mesh file
+	std::string path = "test_MeshCache_modified.su2";
+	std::string cachePath = "test_MeshCache_modified.cache";
+	std::filesystem::copy_file("../../../tests/testmesh.su2", path, std::filesystem::copy_options::overwrite_existing);
+
+	Su2Parser parser(path);
+	parser.Parse();
+	Connectivity connectivity(parser);
+	connectivity.solve();
+	MetricsData metrics;
+	metrics.compute(connectivity);
+
+	MeshCache cache(path, cachePath);
+	cache.open();
+	ASSERT_TRUE(cache.write(parser, connectivity, metrics));
+	ASSERT_TRUE(MeshCache(path, cachePath).open());
+
+	// Act : same size, later modification time
+	std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds(10));
+
+	// Assert
+	EXPECT_FALSE(MeshCache(path, cachePath).open());
+
+	std::remove(path.c_str());
+	std::remove(cachePath.c_str());
+}
+
+TEST(Test_MeshCache, rejectInconsistentSections) {
+	// Arrange : parsed data of one mesh, connectivity and metrics of another one
+	std::string path = "../../../tests/testmesh.su2";
+	std::string cachePath = "test_MeshCache_inconsistent.cache";
+	std::remove(cachePath.c_str());
+
+	Su2Parser parser(path);
+	parser.Parse();
+	Su2Parser otherParser("../../../tests/testmeshMixed.su2");
+	otherParser.Parse();
+	Connectivity otherConnectivity(otherParser);
+	otherConnectivity.solve();
+	MetricsData otherMetrics;
+	otherMetrics.compute(otherConnectivity);
+
+	MeshCache cache(path, cachePath);
+	cache.open();
+	ASSERT_TRUE(cache.write(parser, otherConnectivity, otherMetrics));
+
+	// Act, Assert : the header matches the mesh file but the section sizes don't match its sizes
+	EXPECT_FALSE(MeshCache(path, cachePath).open());
+
+	std::remove(cachePath.c_str());
+}